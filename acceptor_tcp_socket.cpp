@@ -0,0 +1,200 @@
+#include <iostream>
+#include <stdexcept>
+#include <tinythread.h>
+
+#include "acceptor_tcp_socket.hpp"
+
+using namespace nt::http;
+
+static unsigned int
+_get_worker_count(const unsigned int count)
+{
+    if (count != 0) {
+        return count;
+    }
+
+    unsigned int cores = tthread::thread::hardware_concurrency();
+
+    return cores == 0 ? 1 : cores;
+}
+
+static void
+_run_worker(void* arg)
+{
+    auto worker = static_cast<LinuxTcpSocket*>(arg);
+
+    try {
+        worker->open();
+    } catch (std::exception& ex) {
+        std::cerr << "worker stopped: " << ex.what() << std::endl;
+    }
+}
+
+AcceptorTcpSocket::AcceptorTcpSocket(const unsigned int count,
+                                     const unsigned int limit,
+                                     const unsigned int backlog,
+                                     PollBackend backend) :
+      worker_count(_get_worker_count(count)),
+      max_connections(limit),
+      next_worker(0),
+      leave(false)
+{
+    auto server_socket = Connection::create_socket();
+
+    server = std::shared_ptr<Connection>(server_socket);
+
+    for (unsigned int i = 0; i < worker_count; i++) {
+        auto worker = new LinuxTcpSocket(backend);
+        auto queue  = new Handoff(backlog);
+
+        worker->attach(queue);
+
+        workers.push_back(std::unique_ptr<LinuxTcpSocket>(worker));
+        handoffs.push_back(std::unique_ptr<Handoff>(queue));
+    }
+}
+
+AcceptorTcpSocket::~AcceptorTcpSocket() noexcept
+{
+    for (auto& thread : threads) {
+        if (thread->joinable()) {
+            thread->join();
+        }
+    }
+}
+
+void
+AcceptorTcpSocket::bind(const char* server_address, const char* service)
+{
+    server->socket->bind(server_address, service);
+}
+
+void
+AcceptorTcpSocket::bind(const char* server_address, const unsigned short port_no)
+{
+    server->socket->bind(server_address, port_no);
+}
+
+void
+AcceptorTcpSocket::listen(const unsigned int count, event_callback callback)
+{
+    server->socket->listen(count);
+
+    // the workers never listen themselves
+    for (auto& worker : workers) {
+        worker->set_event_callback(callback);
+    }
+}
+
+void
+AcceptorTcpSocket::set_request_handler(interfaces::RequestHandler* handler)
+{
+    for (auto& worker : workers) {
+        worker->set_request_handler(handler);
+    }
+}
+
+void
+AcceptorTcpSocket::set_executor(Executor* executor)
+{
+    for (auto& worker : workers) {
+        worker->set_executor(executor);
+    }
+}
+
+unsigned int
+AcceptorTcpSocket::connection_count() const
+{
+    unsigned int count = 0;
+
+    for (auto& worker : workers) {
+        count += worker->size();
+    }
+
+    return count;
+}
+
+bool
+AcceptorTcpSocket::dispatch(SOCKET client)
+{
+    // start from the round robin position and prefer the least loaded worker
+    unsigned int chosen = next_worker;
+    unsigned int load   = workers[chosen]->size();
+
+    for (unsigned int i = 1; i < worker_count; i++) {
+        unsigned int index = (next_worker + i) % worker_count;
+        unsigned int size  = workers[index]->size();
+
+        if (size < load) {
+            chosen = index;
+            load   = size;
+        }
+    }
+
+    next_worker = (next_worker + 1) % worker_count;
+
+    // a full queue means that worker is behind, try the others before giving up
+    for (unsigned int i = 0; i < worker_count; i++) {
+        unsigned int index = (chosen + i) % worker_count;
+
+        if (handoffs[index]->queue.push(client)) {
+            handoffs[index]->doorbell.ring();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+AcceptorTcpSocket::open()
+{
+    for (auto& worker : workers) {
+        threads.push_back(std::unique_ptr<tthread::thread>(new tthread::thread(_run_worker, worker.get())));
+    }
+
+    while (!leave) {
+        SOCKET client = server->socket->accept();
+
+        if (client == INVALID_SOCKET) {
+            if (leave || errno == EBADF || errno == EINVAL) {
+                break;
+            }
+
+            continue;
+        }
+
+        if (connection_count() >= max_connections || !dispatch(client)) {
+#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
+            std::cout << "dropping connection [" << client << "]" << std::endl;
+#endif
+            ::close(client);
+        }
+    }
+
+    for (auto& worker : workers) {
+        worker->stop();
+    }
+
+    for (auto& thread : threads) {
+        thread->join();
+    }
+
+    threads.clear();
+
+    for (auto& worker : workers) {
+        worker->close();
+    }
+
+    // nothing waits in accept() any more, the descriptor can go
+    server->socket->close();
+}
+
+void
+AcceptorTcpSocket::close()
+{
+    // closing the descriptor does not wake a blocked accept(), shutting it down does
+    ::shutdown(server->socket->socket, SHUT_RDWR);
+
+    leave = true;
+}
@@ -0,0 +1,87 @@
+#ifndef HTTPWEBSERVER_ACCEPTOR_TCP_SOCKET_HPP__
+#define HTTPWEBSERVER_ACCEPTOR_TCP_SOCKET_HPP__
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include "common.hpp"
+#include "poller.hpp"
+#include "handoff.hpp"
+#include "connection.hpp"
+#include "linux_tcp_socket.hpp"
+#include "interfaces/socket.hpp"
+
+namespace tthread {
+class thread;
+}
+
+namespace nt { namespace http {
+
+/**
+ * @brief a single accepting thread feeding worker event loops
+ *
+ * The acceptor blocks in accept() and passes every client socket to the
+ * least loaded worker through that worker's Handoff queue, ringing its
+ * doorbell. Connection limits are enforced here, in one place.
+ */
+class __HttpWebServerSocketPort__ AcceptorTcpSocket :
+      public nt::http::interfaces::Socket
+{
+private:
+    std::shared_ptr<Connection> server;
+
+    const unsigned int worker_count;
+    const unsigned int max_connections;
+
+    std::vector<std::unique_ptr<LinuxTcpSocket>>  workers;
+    std::vector<std::unique_ptr<Handoff>>         handoffs;
+    std::vector<std::unique_ptr<tthread::thread>> threads;
+
+    unsigned int      next_worker;
+    std::atomic<bool> leave;
+
+public:
+    /**
+     * @param count    number of worker threads, 0 for the hardware concurrency
+     * @param limit    maximum number of open connections over all workers
+     * @param backlog  capacity of each worker's hand-off queue
+     */
+    explicit AcceptorTcpSocket(const unsigned int = 0,
+                               const unsigned int = 65536,
+                               const unsigned int = 1024,
+                               PollBackend = PollBackend::Epoll);
+    ~AcceptorTcpSocket() noexcept;
+
+    void bind(const char*, const char*);
+    void bind(const char*, const unsigned short);
+    void listen(const unsigned int, event_callback);
+
+    /**
+     * @brief accept until `close()`, then stop the workers and close the listening socket
+     */
+    void open();
+
+    /**
+     * @brief wake `open()` and make it return, safe to call from any thread
+     */
+    void close();
+
+    /**
+     * @brief the same handler for every worker, it is called from all their threads
+     */
+    void set_request_handler(interfaces::RequestHandler*);
+
+    /**
+     * @brief one executor for the CPU bound requests of every worker
+     */
+    void set_executor(Executor*);
+
+private:
+    unsigned int connection_count() const;
+    bool dispatch(SOCKET);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_ACCEPTOR_TCP_SOCKET_HPP__ */
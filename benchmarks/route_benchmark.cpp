@@ -0,0 +1,231 @@
+/**
+ * @brief route matching in the trie against a linear list of patterns
+ *
+ * Builds a REST API sized route table and matches request targets taken
+ * straight from parsed heads, once through the Router and once by trying
+ * every pattern in turn, segment by segment.
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "http_parser.hpp"
+#include "router.hpp"
+
+#include <macros/leave_loop_if.hpp>
+
+using namespace nt::http;
+
+namespace {
+
+struct Pattern
+{
+    const char* method;
+    const char* path;
+};
+
+const std::vector<Pattern>
+_get_patterns()
+{
+    return {
+        {"GET", "/"},
+        {"GET", "/health"},
+        {"GET", "/metrics"},
+        {"GET", "/static/*path"},
+        {"GET", "/users"},
+        {"POST", "/users"},
+        {"GET", "/users/:user"},
+        {"PUT", "/users/:user"},
+        {"DELETE", "/users/:user"},
+        {"GET", "/users/:user/followers"},
+        {"GET", "/users/:user/following"},
+        {"GET", "/users/:user/repos"},
+        {"GET", "/users/:user/orgs"},
+        {"GET", "/users/:user/keys"},
+        {"GET", "/users/:user/events"},
+        {"GET", "/orgs/:org"},
+        {"GET", "/orgs/:org/members"},
+        {"GET", "/orgs/:org/members/:user"},
+        {"GET", "/orgs/:org/repos"},
+        {"GET", "/orgs/:org/teams"},
+        {"GET", "/repos/:owner/:repo"},
+        {"PATCH", "/repos/:owner/:repo"},
+        {"GET", "/repos/:owner/:repo/issues"},
+        {"POST", "/repos/:owner/:repo/issues"},
+        {"GET", "/repos/:owner/:repo/issues/:number"},
+        {"PATCH", "/repos/:owner/:repo/issues/:number"},
+        {"GET", "/repos/:owner/:repo/issues/:number/comments"},
+        {"POST", "/repos/:owner/:repo/issues/:number/comments"},
+        {"GET", "/repos/:owner/:repo/issues/:number/labels"},
+        {"GET", "/repos/:owner/:repo/pulls"},
+        {"GET", "/repos/:owner/:repo/pulls/:number"},
+        {"GET", "/repos/:owner/:repo/pulls/:number/files"},
+        {"GET", "/repos/:owner/:repo/pulls/:number/commits"},
+        {"PUT", "/repos/:owner/:repo/pulls/:number/merge"},
+        {"GET", "/repos/:owner/:repo/commits"},
+        {"GET", "/repos/:owner/:repo/commits/:sha"},
+        {"GET", "/repos/:owner/:repo/branches"},
+        {"GET", "/repos/:owner/:repo/branches/:branch"},
+        {"GET", "/repos/:owner/:repo/releases"},
+        {"GET", "/repos/:owner/:repo/releases/latest"},
+        {"GET", "/repos/:owner/:repo/releases/:id"},
+        {"GET", "/repos/:owner/:repo/contents/*path"},
+        {"GET", "/search/repositories"},
+        {"GET", "/search/issues"},
+        {"GET", "/search/users"},
+        {"GET", "/notifications"},
+        {"GET", "/gists"},
+        {"GET", "/gists/:id"},
+        {"GET", "/gists/:id/comments"},
+    };
+}
+
+const std::vector<std::string>
+_get_heads()
+{
+    return {
+        "GET /health HTTP/1.1\r\nHost: api.example.com\r\n\r\n",
+        "GET /users/octocat HTTP/1.1\r\nHost: api.example.com\r\n\r\n",
+        "GET /static/js/app.4f3a9c1e.js HTTP/1.1\r\nHost: api.example.com\r\n\r\n",
+        "GET /repos/octocat/hello-world/issues/1347/comments?per_page=50 HTTP/1.1\r\nHost: api.example.com\r\n\r\n",
+        "GET /repos/octocat/hello-world/releases/latest HTTP/1.1\r\nHost: api.example.com\r\n\r\n",
+        "GET /repos/octocat/hello-world/contents/src/main/index.cpp HTTP/1.1\r\nHost: api.example.com\r\n\r\n",
+        "GET /gists/aa5a315d61ae9438b18d/comments HTTP/1.1\r\nHost: api.example.com\r\n\r\n",
+        "GET /no/such/route HTTP/1.1\r\nHost: api.example.com\r\n\r\n",
+    };
+}
+
+void
+_ignore(Connection*, const HttpRequest&, const RouteMatch&, ResponseWriter&)
+{
+}
+
+/**
+ * @brief the obvious alternative, every pattern tried in order
+ */
+bool
+_match_linear(const std::vector<Pattern>& patterns, const StringView& method, const StringView& target, RouteMatch& match)
+{
+    size_t     query = target.find('?');
+    StringView path  = query == StringView::npos ? target : target.substr(0, query);
+
+    for (auto& pattern : patterns) {
+        continue_if (method != StringView(pattern.method));
+
+        StringView rest(pattern.path);
+        StringView left = path;
+
+        match.param_count = 0;
+
+        while (true) {
+            size_t     rest_end = rest.find('/', 1);
+            size_t     left_end = left.find('/', 1);
+            StringView expected = rest.substr(0, rest_end);
+            StringView actual   = left.substr(0, left_end);
+
+            if (expected.size() > 1 && expected[1] == '*') {
+                match.params[match.param_count++] = {expected.substr(2), left.substr(1)};
+                return true;
+            }
+
+            if (expected.size() > 1 && expected[1] == ':') {
+                break_if (actual.size() < 2);
+
+                match.params[match.param_count++] = {expected.substr(2), actual.substr(1)};
+            } else {
+                break_if (expected != actual);
+            }
+
+            if (rest_end == StringView::npos || left_end == StringView::npos) {
+                if (rest_end == left_end) {
+                    return true;
+                }
+
+                break;
+            }
+
+            rest = rest.substr(rest_end);
+            left = left.substr(left_end);
+        }
+    }
+
+    return false;
+}
+
+template<typename F>
+double
+_nanoseconds_per_call(const unsigned int iterations, F run)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < iterations; i++) {
+        run();
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / iterations;
+}
+
+}
+
+int
+main(int argc, char** argv)
+{
+    const unsigned int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const auto         patterns   = _get_patterns();
+    const auto         heads      = _get_heads();
+
+    Router router;
+
+    for (auto& pattern : patterns) {
+        router.add(pattern.method, pattern.path, _ignore);
+    }
+
+    size_t sink = 0;
+
+    std::cout << patterns.size() << " routes, " << iterations << " iterations per target" << std::endl << std::endl
+              << std::left << std::setw(64) << "target"
+              << std::right << std::setw(8) << "params"
+              << std::setw(10) << "trie ns"
+              << std::setw(12) << "linear ns"
+              << std::endl;
+
+    for (auto& head : heads) {
+        HttpParser parser;
+
+        parser.parse(head.data(), head.size());
+
+        // the target is a view into the head, matched where it lies
+        const HttpRequest& request = parser.request();
+
+        RouteMatch match;
+        bool       found = router.match(request.method, request.target, match);
+
+        double trie = _nanoseconds_per_call(iterations, [&]() {
+            sink += router.match(request.method, request.target, match);
+        });
+
+        double linear = _nanoseconds_per_call(iterations, [&]() {
+            sink += _match_linear(patterns, request.method, request.target, match);
+        });
+
+        std::string target(request.target.data(), request.target.size());
+
+        if (target.size() > 60) {
+            target = target.substr(0, 57) + "...";
+        }
+
+        std::cout << std::left << std::setw(64) << target
+                  << std::right << std::setw(8) << (found ? std::to_string(match.param_count) : "-")
+                  << std::setw(10) << std::fixed << std::setprecision(1) << trie
+                  << std::setw(12) << linear
+                  << std::endl;
+    }
+
+    // keeps the loops from being optimised away
+    return sink == 0 ? 1 : 0;
+}
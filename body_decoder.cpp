@@ -0,0 +1,231 @@
+#include "body_decoder.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const uint64_t MAX_SIZE = UINT64_MAX >> 4;
+
+inline int
+_hex_value(const char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief a Content-Length value, digits only
+ */
+bool
+_parse_length(const StringView& value, uint64_t& length)
+{
+    if (value.empty()) {
+        return false;
+    }
+
+    length = 0;
+
+    for (char c : value) {
+        if (c < '0' || c > '9' || length > MAX_SIZE) {
+            return false;
+        }
+
+        length = length * 10 + static_cast<uint64_t>(c - '0');
+    }
+
+    return true;
+}
+
+}
+
+BodyDecoder::BodyDecoder()
+{
+    reset();
+}
+
+void
+BodyDecoder::reset()
+{
+    state      = State::Done;
+    remaining  = 0;
+    has_digits = false;
+}
+
+bool
+BodyDecoder::start(const HttpRequest& request)
+{
+    const HttpHeader* encoding   = nullptr;
+    bool              has_length = false;
+    uint64_t          length     = 0;
+
+    reset();
+
+    for (unsigned int i = 0; i < request.header_count; i++) {
+        const HttpHeader& header = request.headers[i];
+
+        if (header.name.equals_ignore_case("transfer-encoding")) {
+            // a second one could hide a coding from us
+            if (encoding != nullptr) {
+                return false;
+            }
+
+            encoding = &header;
+        } else if (header.name.equals_ignore_case("content-length")) {
+            uint64_t value;
+
+            // repeats are only tolerated when they agree
+            if (!_parse_length(header.value, value) || (has_length && value != length)) {
+                return false;
+            }
+
+            has_length = true;
+            length     = value;
+        }
+    }
+
+    if (encoding != nullptr) {
+        // chunked is the only coding understood, and the length would be a lie
+        if (has_length || !encoding->value.equals_ignore_case("chunked")) {
+            return false;
+        }
+
+        state = State::ChunkSize;
+    } else if (length > 0) {
+        state     = State::Length;
+        remaining = length;
+    }
+
+    return true;
+}
+
+BodyDecoder::Result
+BodyDecoder::next(const char* data, const size_t size, size_t& skipped, StringView& slice)
+{
+    size_t i = 0;
+
+    skipped = 0;
+
+    while (true) {
+        if (state == State::Done) {
+            skipped = i;
+            return Result::Done;
+        } else if (state == State::Length || state == State::ChunkData) {
+            if (i == size) {
+                skipped = i;
+                return Result::NeedMore;
+            }
+
+            size_t available = size - i;
+
+            skipped = i;
+            slice   = StringView(data + i, remaining < available ? static_cast<size_t>(remaining) : available);
+
+            return Result::Data;
+        } else if (i == size) {
+            skipped = i;
+            return Result::NeedMore;
+        }
+
+        char c = data[i++];
+
+        switch (state) {
+        case State::ChunkSize:
+            if (_hex_value(c) >= 0) {
+                if (remaining > MAX_SIZE) {
+                    return Result::Error;
+                }
+
+                remaining  = remaining * 16 + static_cast<uint64_t>(_hex_value(c));
+                has_digits = true;
+            } else if (!has_digits) {
+                return Result::Error;
+            } else if (c == ';' || c == ' ' || c == '\t') {
+                state = State::ChunkExtension;
+            } else if (c == '\r') {
+                state = State::ChunkSizeLf;
+            } else {
+                return Result::Error;
+            }
+            break;
+
+        case State::ChunkExtension:
+            // extensions carry nothing we use
+            if (c == '\r') {
+                state = State::ChunkSizeLf;
+            } else if (c == '\n') {
+                return Result::Error;
+            }
+            break;
+
+        case State::ChunkSizeLf:
+            if (c != '\n') {
+                return Result::Error;
+            }
+
+            has_digits = false;
+            state      = remaining == 0 ? State::TrailerStart : State::ChunkData;
+            break;
+
+        case State::ChunkDataCr:
+            if (c != '\r') {
+                return Result::Error;
+            }
+
+            state = State::ChunkDataLf;
+            break;
+
+        case State::ChunkDataLf:
+            if (c != '\n') {
+                return Result::Error;
+            }
+
+            state = State::ChunkSize;
+            break;
+
+        case State::TrailerStart:
+            state = c == '\r' ? State::TrailerEndLf : State::TrailerLine;
+            break;
+
+        case State::TrailerLine:
+            // trailer fields are passed over
+            if (c == '\n') {
+                state = State::TrailerStart;
+            }
+            break;
+
+        case State::TrailerEndLf:
+            if (c != '\n') {
+                return Result::Error;
+            }
+
+            state = State::Done;
+            break;
+
+        default:
+            return Result::Error;
+        }
+    }
+}
+
+void
+BodyDecoder::consume(const size_t n)
+{
+    remaining -= n;
+
+    if (remaining == 0) {
+        state = state == State::ChunkData ? State::ChunkDataCr : State::Done;
+    }
+}
+
+bool
+BodyDecoder::is_done() const
+{
+    return state == State::Done;
+}
@@ -0,0 +1,88 @@
+#ifndef HTTPWEBSERVER_SOCKET_BODY_DECODER_HPP__
+#define HTTPWEBSERVER_SOCKET_BODY_DECODER_HPP__
+
+#include <cstdint>
+#include <cstddef>
+
+#include "common.hpp"
+#include "string_view.hpp"
+#include "http_parser.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief finds the payload of a request body, framed by Content-Length or chunked
+ *
+ * The decoder never copies: `next()` skips framing (chunk sizes, line
+ * ends, trailers) and points at the payload bytes that follow, straight
+ * in the caller's buffer. The caller hands the payload on and reports how
+ * much of it was taken with `consume()`; whatever was not taken is
+ * offered again by the next call.
+ */
+class __HttpWebServerSocketPort__ BodyDecoder
+{
+public:
+    enum class Result
+    {
+        Data,
+        NeedMore,
+        Done,
+        Error
+    };
+
+private:
+    enum class State : unsigned char
+    {
+        Length,
+        ChunkSize,
+        ChunkExtension,
+        ChunkSizeLf,
+        ChunkData,
+        ChunkDataCr,
+        ChunkDataLf,
+        TrailerStart,
+        TrailerLine,
+        TrailerEndLf,
+        Done
+    };
+
+    State    state;
+    uint64_t remaining;
+    bool     has_digits;
+
+public:
+    BodyDecoder();
+
+    /**
+     * @brief no body
+     */
+    void reset();
+
+    /**
+     * @brief pick the framing from the request's headers
+     * @return false when the framing is invalid or ambiguous, e.g. both
+     *         Content-Length and Transfer-Encoding, or an unknown coding
+     */
+    bool start(const HttpRequest&);
+
+    /**
+     * @param data    raw body bytes not looked at yet
+     * @param size    number of them
+     * @param skipped set to the framing bytes passed over before `slice`,
+     *                or before the end of the body for `Done`
+     * @param slice   set to the payload bytes found, for `Data`
+     */
+    Result next(const char*, const size_t, size_t&, StringView&);
+
+    /**
+     * @brief the first `n` bytes of the last slice were handled
+     */
+    void consume(const size_t);
+
+    bool is_done() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_BODY_DECODER_HPP__ */
@@ -0,0 +1,164 @@
+#include <cstring>
+
+#include "buffer.hpp"
+
+using namespace nt::http;
+
+Buffer::Buffer() :
+      pool(nullptr),
+      block(nullptr),
+      capacity(0),
+      head(0),
+      tail(0)
+{
+}
+
+Buffer::~Buffer() noexcept
+{
+    release();
+}
+
+void
+Buffer::set_pool(BufferPool* buffer_pool)
+{
+    release();
+
+    pool = buffer_pool;
+}
+
+const char*
+Buffer::data() const
+{
+    return block + head;
+}
+
+size_t
+Buffer::size() const
+{
+    return tail - head;
+}
+
+bool
+Buffer::empty() const
+{
+    return tail == head;
+}
+
+char*
+Buffer::prepare(const size_t count)
+{
+    size_t used = tail - head;
+
+    if (capacity - tail >= count) {
+        return block + tail;
+    }
+
+    if (capacity - used >= count) {
+        // enough room in total, move the data back to the start
+        std::memmove(block, block + head, used);
+    } else {
+        size_t chunk = pool != nullptr ? pool->chunk_size : 0;
+        size_t size  = capacity != 0 ? capacity * 2 : chunk;
+
+        if (size < used + count) {
+            size = used + count;
+        }
+
+        char* larger = pool != nullptr && size == chunk ? pool->acquire() : new char[size];
+
+        if (used != 0) {
+            std::memcpy(larger, block + head, used);
+        }
+
+        release();
+
+        block    = larger;
+        capacity = size;
+    }
+
+    head = 0;
+    tail = used;
+
+    return block + tail;
+}
+
+size_t
+Buffer::room() const
+{
+    return capacity - tail;
+}
+
+void
+Buffer::commit(const size_t count)
+{
+    tail += count;
+}
+
+void
+Buffer::append(const char* bytes, const size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    std::memcpy(prepare(count), bytes, count);
+
+    tail += count;
+}
+
+void
+Buffer::append(const std::string& bytes)
+{
+    append(bytes.data(), bytes.size());
+}
+
+void
+Buffer::consume(const size_t count)
+{
+    head += count;
+
+    if (head == tail) {
+        release();
+    }
+}
+
+void
+Buffer::erase(const size_t offset, const size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    char* at = block + head + offset;
+
+    std::memmove(at, at + count, tail - head - offset - count);
+
+    tail -= count;
+
+    if (head == tail) {
+        release();
+    }
+}
+
+void
+Buffer::clear()
+{
+    release();
+}
+
+void
+Buffer::release()
+{
+    if (block != nullptr) {
+        if (pool != nullptr && capacity == pool->chunk_size) {
+            pool->release(block);
+        } else {
+            delete[] block;
+        }
+    }
+
+    block    = nullptr;
+    capacity = 0;
+    head     = 0;
+    tail     = 0;
+}
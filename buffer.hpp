@@ -0,0 +1,81 @@
+#ifndef HTTPWEBSERVER_SOCKET_BUFFER_HPP__
+#define HTTPWEBSERVER_SOCKET_BUFFER_HPP__
+
+#include <cstddef>
+#include <string>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "buffer_pool.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief byte queue that only holds memory while it holds data
+ *
+ * Storage is a chunk from the pool, or a larger block from the heap once
+ * the data outgrows a chunk; either is given back as soon as the buffer
+ * runs empty. Consuming from the front only moves an offset, the bytes
+ * are moved back to the start when the end runs out of room. The data
+ * stays contiguous so it can be parsed in place, which means pointers into
+ * it are invalidated by `prepare()` and `append()`.
+ */
+class __HttpWebServerSocketPort__ Buffer
+{
+private:
+    BufferPool* pool;
+    char*       block;
+    size_t      capacity;
+    size_t      head;
+    size_t      tail;
+
+public:
+    Buffer();
+    ~Buffer() noexcept;
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    /**
+     * @brief where storage comes from, the heap without a pool
+     */
+    void set_pool(BufferPool*);
+
+    const char* data() const;
+    size_t size() const;
+    bool empty() const;
+
+    /**
+     * @brief make room for at least `count` more bytes
+     * @return where they go, `room()` bytes may be written there
+     */
+    char* prepare(const size_t);
+    size_t room() const;
+
+    /**
+     * @brief take `count` bytes written after `prepare()`
+     */
+    void commit(const size_t);
+
+    void append(const char*, const size_t);
+    void append(const std::string&);
+
+    /**
+     * @brief drop `count` bytes from the front
+     */
+    void consume(const size_t);
+
+    /**
+     * @brief drop `count` bytes starting at `offset`
+     */
+    void erase(const size_t, const size_t);
+
+    void clear();
+
+private:
+    void release();
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_BUFFER_HPP__ */
@@ -0,0 +1,60 @@
+#include "buffer_pool.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const size_t CHUNK_SIZE = 16 * 1024;
+const size_t MAX_FREE   = 1024;
+
+}
+
+BufferPool::BufferPool() :
+      BufferPool(CHUNK_SIZE, MAX_FREE)
+{
+}
+
+BufferPool::BufferPool(const size_t size, const size_t free) :
+      chunk_size(_chunk_size),
+      _chunk_size(size),
+      max_free(free)
+{
+}
+
+BufferPool::~BufferPool() noexcept
+{
+    for (auto chunk : chunks) {
+        delete[] chunk;
+    }
+}
+
+char*
+BufferPool::acquire()
+{
+    if (chunks.empty()) {
+        return new char[_chunk_size];
+    }
+
+    char* chunk = chunks.back();
+
+    chunks.pop_back();
+
+    return chunk;
+}
+
+void
+BufferPool::release(char* chunk)
+{
+    // past the limit a burst is over, the memory goes back to the system
+    if (chunks.size() >= max_free) {
+        delete[] chunk;
+    } else {
+        chunks.push_back(chunk);
+    }
+}
+
+size_t
+BufferPool::size() const
+{
+    return chunks.size();
+}
@@ -0,0 +1,47 @@
+#ifndef HTTPWEBSERVER_SOCKET_BUFFER_POOL_HPP__
+#define HTTPWEBSERVER_SOCKET_BUFFER_POOL_HPP__
+
+#include <cstddef>
+#include <vector>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief fixed-size chunks shared by the connections of one event loop
+ *
+ * Released chunks are kept for reuse, up to a limit, so a steady load does
+ * not touch the allocator. Not thread safe, every loop has its own pool.
+ */
+class __HttpWebServerSocketPort__ BufferPool
+{
+public:
+    const size_t& chunk_size;
+private:
+    size_t _chunk_size;
+    size_t max_free;
+
+    std::vector<char*> chunks;
+
+public:
+    BufferPool();
+    BufferPool(const size_t, const size_t);
+    ~BufferPool() noexcept;
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    char* acquire();
+    void release(char*);
+
+    /**
+     * @brief chunks waiting for reuse
+     */
+    size_t size() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_BUFFER_POOL_HPP__ */
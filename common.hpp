@@ -0,0 +1,46 @@
+#ifndef HTTPWEBSERVER_SOCKET_COMMON_HPP__
+#define HTTPWEBSERVER_SOCKET_COMMON_HPP__
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+// #include "interfaces/socket.hpp"
+#define LINUX
+/* #undef LOSE */
+/* #undef BANANA */
+/* #undef HTTP_WEB_SERVER_SOCKET_DEBUG */
+#define HAVE_IO_URING
+
+#ifdef LOSE
+#   include <winsock2.h>
+#   include <ws2tcpip.h>
+#   include <io.h>
+#
+#   define HOST_NAME_MAX  256
+#elif defined(LINUX)
+#   include <sys/types.h>
+#   include <sys/stat.h>
+#   include <sys/socket.h>
+#   include <netinet/in.h>
+#   include <arpa/inet.h>
+#   include <netdb.h>
+#   include <unistd.h>
+#   include <errno.h>
+#   include <limits.h>
+#   include <unistd.h>
+#
+#   define SOCKET         int
+#   define SOCKET_ERROR   -1
+#   define INVALID_SOCKET -1
+#endif
+
+#include <fcntl.h>
+
+#ifndef MAX_INPUT
+#   define MAX_INPUT 256
+#endif
+
+#define SOCKET_NOERROR 0
+
+#endif /* HTTPWEBSERVER_SOCKET_COMMON_HPP__ */
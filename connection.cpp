@@ -2,28 +2,51 @@
 
 using namespace nt::http;
 
+Connection::Connection() :
+      socket(&raw),
+      handle{0, 0},
+      parser(nullptr),
+      parsers(nullptr)
+{
+}
 
+Connection::Connection(SOCKET s) :
+      raw(s),
+      socket(&raw),
+      handle{0, 0},
+      parser(nullptr),
+      parsers(nullptr)
+{
+}
+
+Connection::~Connection() noexcept
+{
+    release_parser();
+}
 
 Connection*
 Connection::create_socket()
 {
     auto cx = new Connection();
 
-    cx->socket  = std::make_shared<RawSocket>();
-    cx->event   = std::make_shared<OverlappedEvent>(cx->socket.get());
-    cx->is_read = false;
+#ifdef LOSE
+    cx->event   = std::make_shared<OverlappedEvent>(cx->socket);
+#endif
+    cx->reset();
 
     return cx;
 }
 
+#ifdef LOSE
 Connection*
 Connection::create_socket(std::shared_ptr<RawSocket>& s)
 {
     auto cx = new Connection();
 
-    cx->socket  = s;
-    cx->event   = std::make_shared<OverlappedEvent>(cx->socket.get());
-    cx->is_read = false;
+    cx->shared  = s;
+    cx->socket  = s.get();
+    cx->event   = std::make_shared<OverlappedEvent>(cx->socket);
+    cx->reset();
 
     return cx;
 }
@@ -35,10 +58,70 @@ Connection::create_pipe(const std::string& pipe_name)
 
     cx->pipe    = std::make_shared<Pipe>(pipe_name);
     cx->event   = std::make_shared<OverlappedEvent>();
-    cx->is_read = false;
+    cx->reset();
 
     return cx;
 }
+#endif
+
+void
+Connection::reset()
+{
+    is_closing   = false;
+    is_paused    = false;
+    is_dirty     = false;
+    is_throttled = false;
+    is_waiting   = false;
+    interest     = 0;
+    request_size = 0;
+    consumed     = 0;
+    keep_alive   = false;
+    requests     = 0;
+    timer.kind   = 0;
+    timer.data   = this;
+
+#ifdef LOSE
+    is_read      = false;
+#endif
+
+    input.clear();
+    output.clear();
+    body.reset();
+
+    release_parser();
+}
+
+void
+Connection::set_parser_pool(ParserPool* pool)
+{
+    parsers = pool;
+}
+
+HttpParser&
+Connection::acquire_parser()
+{
+    if (parser == nullptr) {
+        parser = parsers != nullptr ? parsers->acquire() : new HttpParser();
+    }
+
+    return *parser;
+}
+
+void
+Connection::release_parser()
+{
+    if (parser == nullptr) {
+        return;
+    }
+
+    if (parsers != nullptr) {
+        parsers->release(parser);
+    } else {
+        delete parser;
+    }
+
+    parser = nullptr;
+}
 
 namespace nt { namespace http {
 
@@ -47,10 +130,14 @@ operator<<(std::ostream& out, const Connection& con)
 {
     out << "Connection";
 
+#ifdef LOSE
     if (!con.name.empty()) {
         out << " \"" << con.name << "\"";
 
     }
+#else
+    out << " [" << con.socket->socket << "]";
+#endif
 
     // out << " (" << static_cast<int>(con.socket) << ")";
 
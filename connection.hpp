@@ -2,38 +2,169 @@
 #define HTTPWEBSERVER_SOCKET_CONNECTION_HPP__
 
 #include <memory>
+#include <cstdint>
 
 #include "common.hpp"
 #include "raw_socket.hpp"
-#include "overlapped_event.hpp"
-#include "pipe.hpp"
+#include "timer_wheel.hpp"
+#include "http_parser.hpp"
+#include "parser_pool.hpp"
+#include "body_decoder.hpp"
+#include "buffer.hpp"
+#include "output_queue.hpp"
+
+#ifdef LOSE
+#   include "overlapped_event.hpp"
+#   include "pipe.hpp"
+#endif
 
 namespace nt { namespace http {
 
+/**
+ * @brief names a connection without owning it, stale once the connection is gone
+ */
+struct ConnectionHandle
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+/**
+ * @brief state of one socket
+ *
+ * What the event loop touches on every wakeup comes first, the request
+ * state after it and what only some platforms use last. The request head
+ * parser comes from a pool and is only held while a request is under way.
+ */
 class Connection
 {
+private:
+    RawSocket raw;
+
 public:
-    std::shared_ptr<Pipe> pipe;
-    std::shared_ptr<OverlappedEvent> event;
-    std::shared_ptr<RawSocket> socket;
+    /**
+     * @brief the connection's own socket, or one shared with whoever created it
+     */
+    RawSocket* socket;
+
+    ConnectionHandle handle;
+
+    bool is_closing;
+
+    /**
+     * @brief the body handler is full, reading waits for a resume
+     */
+    bool is_paused;
+
+    /**
+     * @brief queued for a flush at the end of the loop iteration
+     */
+    bool is_dirty;
+
+    /**
+     * @brief requests wait for queued output to drain before they are answered
+     */
+    bool is_throttled;
+
+    /**
+     * @brief a request is being answered on the executor, nothing after it is processed meanwhile
+     */
+    bool is_waiting;
+
+    bool keep_alive;
+
+    /**
+     * @brief what the poller currently watches for
+     */
+    unsigned int interest;
+    unsigned int requests;
+
+    size_t request_size;
+
+    /**
+     * @brief bytes at the front of `input` already answered in the current batch
+     */
+    size_t consumed;
+
+    /**
+     * @brief the one deadline currently running, idle, header or write
+     */
+    Timer timer;
+
+    /**
+     * @brief bytes received but not yet answered, may hold the start of the next request
+     */
+    Buffer input;
 
+    /**
+     * @brief responses not yet sent, in the order their requests came in
+     */
+    OutputQueue output;
+
+    /**
+     * @brief picks up the request in `input` where the last read left it, nullptr between requests
+     */
+    HttpParser* parser;
+
+    /**
+     * @brief framing of the current request's body, already passed on bytes are dropped from `input`
+     */
+    BodyDecoder body;
+
+#ifdef LOSE
     /**
      * @brief has date been read from the device
      */
     bool is_read;
+
+    std::shared_ptr<Pipe> pipe;
+    std::shared_ptr<OverlappedEvent> event;
     std::string name;
 
 private:
-    Connection() = default;
+    std::shared_ptr<RawSocket> shared;
+#endif
+
+private:
+    ParserPool* parsers;
+
+private:
+    Connection();
+    explicit Connection(SOCKET);
 
 public:
-    ~Connection() noexcept = default;
+    ~Connection() noexcept;
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
 
     static Connection* create_socket();
+#ifdef LOSE
     static Connection* create_socket(std::shared_ptr<RawSocket>&);
     static Connection* create_pipe(const std::string&);
+#endif
+
+    /**
+     * @brief back to the state of a freshly accepted connection
+     */
+    void reset();
 
+    /**
+     * @brief where `parser` comes from, the heap without a pool
+     */
+    void set_parser_pool(ParserPool*);
+
+    /**
+     * @brief hold a parser for the request arriving in `input`, the one already held if any
+     */
+    HttpParser& acquire_parser();
+
+    /**
+     * @brief give the parser back, the connection is between requests
+     */
+    void release_parser();
 
+    friend class ConnectionSlab;
     friend std::ostream& operator<<(std::ostream&, const Connection&);
 };
 
@@ -0,0 +1,107 @@
+#include <new>
+
+#include "connection_slab.hpp"
+
+using namespace nt::http;
+
+ConnectionSlab::ConnectionSlab() :
+      free_slot(NO_SLOT),
+      slots(0),
+      count(0)
+{
+}
+
+ConnectionSlab::~ConnectionSlab() noexcept
+{
+    clear();
+}
+
+ConnectionSlab::Slot&
+ConnectionSlab::get_slot(const uint32_t index) const
+{
+    return pages[index / PAGE_SIZE][index % PAGE_SIZE];
+}
+
+Connection*
+ConnectionSlab::create(SOCKET socket)
+{
+    if (free_slot == NO_SLOT) {
+        // a whole page at once, its slots are chained into the free list back to front
+        pages.push_back(std::unique_ptr<Slot[]>(new Slot[PAGE_SIZE]));
+
+        for (uint32_t i = PAGE_SIZE; i-- > 0;) {
+            Slot& slot = pages.back()[i];
+
+            slot.generation = 0;
+            slot.next_free  = free_slot;
+            slot.is_live    = false;
+
+            free_slot = slots + i;
+        }
+
+        slots += PAGE_SIZE;
+    }
+
+    uint32_t index = free_slot;
+    Slot&    slot  = get_slot(index);
+
+    free_slot = slot.next_free;
+
+    auto connection = new (&slot.storage) Connection(socket);
+
+    connection->reset();
+    connection->handle = {index, slot.generation};
+
+    slot.is_live = true;
+    count++;
+
+    return connection;
+}
+
+void
+ConnectionSlab::destroy(Connection* connection)
+{
+    uint32_t index = connection->handle.index;
+    Slot&    slot  = get_slot(index);
+
+    connection->~Connection();
+
+    slot.generation++;
+    slot.is_live   = false;
+    slot.next_free = free_slot;
+
+    free_slot = index;
+    count--;
+}
+
+Connection*
+ConnectionSlab::find(const ConnectionHandle& handle) const
+{
+    if (handle.index >= slots) {
+        return nullptr;
+    }
+
+    Slot& slot = get_slot(handle.index);
+
+    if (!slot.is_live || slot.generation != handle.generation) {
+        return nullptr;
+    }
+
+    return reinterpret_cast<Connection*>(&slot.storage);
+}
+
+void
+ConnectionSlab::clear()
+{
+    for (uint32_t i = 0; i < slots && count != 0; i++) {
+        if (get_slot(i).is_live) {
+            destroy(reinterpret_cast<Connection*>(&get_slot(i).storage));
+        }
+    }
+}
+
+size_t
+ConnectionSlab::size() const
+{
+    return count;
+}
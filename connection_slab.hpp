@@ -0,0 +1,75 @@
+#ifndef HTTPWEBSERVER_SOCKET_CONNECTION_SLAB_HPP__
+#define HTTPWEBSERVER_SOCKET_CONNECTION_SLAB_HPP__
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "connection.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief owns the client connections of one event loop
+ *
+ * Connections are built in place in pages of slots that are never freed,
+ * so a closed connection's slot is reused by the next accept without going
+ * through the allocator. Every reuse bumps the slot's generation, which
+ * makes handles to the previous occupant stale. Not thread safe.
+ */
+class __HttpWebServerSocketPort__ ConnectionSlab
+{
+private:
+    static const uint32_t PAGE_SIZE = 64;
+    static const uint32_t NO_SLOT   = UINT32_MAX;
+
+    struct Slot
+    {
+        typename std::aligned_storage<sizeof(Connection), alignof(Connection)>::type storage;
+
+        uint32_t generation;
+        uint32_t next_free;
+        bool     is_live;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> pages;
+
+    uint32_t free_slot;
+    uint32_t slots;
+    size_t   count;
+
+public:
+    ConnectionSlab();
+    ~ConnectionSlab() noexcept;
+
+    ConnectionSlab(const ConnectionSlab&) = delete;
+    ConnectionSlab& operator=(const ConnectionSlab&) = delete;
+
+    /**
+     * @brief a connection owning `socket`, closed again by `destroy()`
+     */
+    Connection* create(SOCKET);
+    void destroy(Connection*);
+
+    /**
+     * @brief the connection a handle names, nullptr once it has been destroyed
+     */
+    Connection* find(const ConnectionHandle&) const;
+
+    /**
+     * @brief destroy every connection
+     */
+    void clear();
+
+    size_t size() const;
+
+private:
+    Slot& get_slot(const uint32_t) const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_CONNECTION_SLAB_HPP__ */
@@ -0,0 +1,73 @@
+#include "connection_table.hpp"
+
+using namespace nt::http;
+
+void
+ConnectionTable::insert(Connection* connection)
+{
+    auto socket = static_cast<size_t>(connection->socket->socket);
+
+    if (socket >= sockets.size()) {
+        sockets.resize(socket + 1, Entry{nullptr, 0});
+    }
+
+    sockets[socket] = {connection, static_cast<uint32_t>(live.size())};
+
+    live.push_back(connection);
+}
+
+void
+ConnectionTable::erase(const Connection* connection)
+{
+    auto   socket = static_cast<size_t>(connection->socket->socket);
+    Entry& entry  = sockets[socket];
+
+    // the last live connection fills the gap
+    Connection* last = live.back();
+
+    live[entry.position] = last;
+    sockets[static_cast<size_t>(last->socket->socket)].position = entry.position;
+
+    live.pop_back();
+
+    entry = {nullptr, 0};
+}
+
+Connection*
+ConnectionTable::find(const SOCKET socket) const
+{
+    auto index = static_cast<size_t>(socket);
+
+    return index < sockets.size() ? sockets[index].connection : nullptr;
+}
+
+size_t
+ConnectionTable::size() const
+{
+    return live.size();
+}
+
+bool
+ConnectionTable::empty() const
+{
+    return live.empty();
+}
+
+void
+ConnectionTable::clear()
+{
+    sockets.clear();
+    live.clear();
+}
+
+ConnectionTable::const_iterator
+ConnectionTable::begin() const
+{
+    return live.begin();
+}
+
+ConnectionTable::const_iterator
+ConnectionTable::end() const
+{
+    return live.end();
+}
@@ -0,0 +1,59 @@
+#ifndef HTTPWEBSERVER_SOCKET_CONNECTION_TABLE_HPP__
+#define HTTPWEBSERVER_SOCKET_CONNECTION_TABLE_HPP__
+
+#include <vector>
+#include <cstdint>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "connection.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief the open connections of one event loop, indexed by socket
+ *
+ * Descriptors are small and reused lowest first, so a table indexed by
+ * them stays dense. Next to it a packed list of the live connections is
+ * kept for iteration; removal moves the last entry into the gap. Insert,
+ * lookup and removal are O(1), iteration only visits live connections.
+ */
+class __HttpWebServerSocketPort__ ConnectionTable
+{
+private:
+    struct Entry
+    {
+        Connection* connection;
+        uint32_t    position;
+    };
+
+    std::vector<Entry>       sockets;
+    std::vector<Connection*> live;
+
+public:
+    typedef std::vector<Connection*>::const_iterator const_iterator;
+
+    ConnectionTable() = default;
+
+    ConnectionTable(const ConnectionTable&) = delete;
+    ConnectionTable& operator=(const ConnectionTable&) = delete;
+
+    void insert(Connection*);
+    void erase(const Connection*);
+
+    /**
+     * @brief the connection on a socket, nullptr if there is none
+     */
+    Connection* find(const SOCKET) const;
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    const_iterator begin() const;
+    const_iterator end() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_CONNECTION_TABLE_HPP__ */
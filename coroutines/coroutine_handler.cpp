@@ -0,0 +1,136 @@
+#include "coroutine_handler.hpp"
+
+#include <algorithm>
+
+#include "connection.hpp"
+
+using namespace nt::http;
+
+CoroutineHandler::CoroutineHandler(LinuxTcpSocket& loop) :
+      socket(loop)
+{
+    socket.set_request_handler(this);
+    socket.set_body_handler(this);
+}
+
+CoroutineHandler::~CoroutineHandler() noexcept
+{
+    socket.set_request_handler(nullptr);
+    socket.set_body_handler(nullptr);
+}
+
+void
+CoroutineHandler::on_request(Connection* connection, const HttpRequest&, ResponseWriter& writer)
+{
+    RequestContext& context = get_context(connection);
+
+    // the whole body has been read by now, if there was one
+    context.has_body_ended = true;
+
+    if (!context.root.handle()) {
+        context.start(connection, writer.is_keep_alive());
+    }
+
+    if (!context.root.is_done()) {
+        context.is_deferred = true;
+
+        writer.defer();
+        return;
+    }
+
+    context.settle();
+
+    bool keep_alive = context.writer->is_keep_alive();
+
+    writer.send(context.output);
+
+    if (!keep_alive) {
+        writer.close();
+    }
+
+    context.reset();
+}
+
+void
+CoroutineHandler::on_close(Connection* connection)
+{
+    size_t index = connection->handle.index;
+
+    if (index >= contexts.size() || !contexts[index]) {
+        return;
+    }
+
+    std::unique_ptr<RequestContext> context(std::move(contexts[index]));
+
+    context->is_closed = true;
+
+    // a worker may still be writing into a frame, it goes when the job is back
+    if (context->pending != 0) {
+        closed.push_back(std::move(context));
+    }
+}
+
+size_t
+CoroutineHandler::on_body(Connection* connection, const StringView& slice)
+{
+    RequestContext& context = get_context(connection);
+
+    if (!context.root.handle()) {
+        context.start(connection, connection->keep_alive);
+    }
+
+    // a handler that has answered does not care for the rest
+    if (context.root.is_done()) {
+        return slice.size();
+    }
+
+    if (context.body_waiter == nullptr) {
+        context.is_reading_blocked = true;
+        return 0;
+    }
+
+    context.deliver(slice);
+
+    return slice.size();
+}
+
+void
+CoroutineHandler::on_body_end(Connection* connection)
+{
+    RequestContext& context = get_context(connection);
+
+    context.has_body_ended = true;
+
+    if (context.body_waiter != nullptr) {
+        context.deliver(StringView());
+    }
+}
+
+RequestContext&
+CoroutineHandler::get_context(Connection* connection)
+{
+    size_t index = connection->handle.index;
+
+    if (index >= contexts.size()) {
+        contexts.resize(index + 1);
+    }
+
+    // a slot's previous connection took its context along when it closed
+    if (!contexts[index]) {
+        contexts[index].reset(new RequestContext(*this, socket, connection->handle));
+    }
+
+    return *contexts[index];
+}
+
+void
+CoroutineHandler::release(RequestContext* context)
+{
+    auto found = std::find_if(closed.begin(), closed.end(), [context](const std::unique_ptr<RequestContext>& item) {
+        return item.get() == context;
+    });
+
+    if (found != closed.end()) {
+        closed.erase(found);
+    }
+}
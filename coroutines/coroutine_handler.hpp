@@ -0,0 +1,77 @@
+#ifndef HTTPWEBSERVER_SOCKET_COROUTINE_HANDLER_HPP__
+#define HTTPWEBSERVER_SOCKET_COROUTINE_HANDLER_HPP__
+
+#include <memory>
+#include <vector>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "interfaces/request_handler.hpp"
+#include "interfaces/body_handler.hpp"
+#include "linux_tcp_socket.hpp"
+
+#include "task.hpp"
+#include "request_context.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief request handler written as a coroutine
+ *
+ * `handle()` is started when the first piece of the body comes in, or
+ * with the request when there is none, and may wait for the body, a
+ * timer, a descriptor or work on an executor without holding up the
+ * loop; the requests behind it on the same connection wait their turn.
+ * When it returns, whatever it wrote is sent. Installs itself as both
+ * the request and the body handler of one event loop, which has to
+ * outlive it.
+ */
+class __HttpWebServerSocketPort__ CoroutineHandler :
+      public interfaces::RequestHandler,
+      public interfaces::BodyHandler
+{
+private:
+    LinuxTcpSocket& socket;
+
+    /**
+     * @brief by connection slot
+     */
+    std::vector<std::unique_ptr<RequestContext>> contexts;
+
+    /**
+     * @brief of closed connections, kept until their executor jobs come back
+     */
+    std::vector<std::unique_ptr<RequestContext>> closed;
+
+    friend class RequestContext;
+
+public:
+    explicit CoroutineHandler(LinuxTcpSocket&);
+    ~CoroutineHandler() noexcept override;
+
+    CoroutineHandler(const CoroutineHandler&) = delete;
+    CoroutineHandler& operator=(const CoroutineHandler&) = delete;
+
+    /**
+     * @brief answer `context.request()` through `context.response()`
+     */
+    virtual Task handle(RequestContext&) = 0;
+
+    void on_request(Connection*, const HttpRequest&, ResponseWriter&) override;
+    void on_close(Connection*) override;
+
+    size_t on_body(Connection*, const StringView&) override;
+    void on_body_end(Connection*) override;
+
+private:
+    RequestContext& get_context(Connection*);
+
+    /**
+     * @brief forget a closed connection's context once nothing points into it
+     */
+    void release(RequestContext*);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_COROUTINE_HANDLER_HPP__ */
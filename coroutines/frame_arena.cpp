@@ -0,0 +1,85 @@
+#include "frame_arena.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const size_t ALIGNMENT = alignof(std::max_align_t);
+
+size_t
+_align(const size_t size)
+{
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+}
+
+FrameArena::FrameArena(const size_t size) :
+      current(0),
+      block_size(size)
+{
+}
+
+void*
+FrameArena::allocate(size_t size)
+{
+    size = _align(size);
+
+    // blocks after the current one are left over from an earlier request
+    for (; current < blocks.size(); current++) {
+        Block& block = blocks[current];
+
+        if (block.size - block.used >= size) {
+            void* memory = block.memory.get() + block.used;
+
+            block.used += size;
+
+            return memory;
+        }
+    }
+
+    size_t capacity = size > block_size ? size : block_size;
+
+    blocks.push_back({std::unique_ptr<char[]>(new char[capacity]), capacity, size});
+    current = blocks.size() - 1;
+
+    return blocks.back().memory.get();
+}
+
+void
+FrameArena::release(void* memory, size_t size)
+{
+    if (current >= blocks.size()) {
+        return;
+    }
+
+    Block& block = blocks[current];
+
+    size = _align(size);
+
+    if (static_cast<char*>(memory) + size == block.memory.get() + block.used) {
+        block.used -= size;
+    }
+}
+
+void
+FrameArena::reset()
+{
+    for (auto& block : blocks) {
+        block.used = 0;
+    }
+
+    current = 0;
+}
+
+size_t
+FrameArena::capacity() const
+{
+    size_t total = 0;
+
+    for (auto& block : blocks) {
+        total += block.size;
+    }
+
+    return total;
+}
@@ -0,0 +1,58 @@
+#ifndef HTTPWEBSERVER_SOCKET_FRAME_ARENA_HPP__
+#define HTTPWEBSERVER_SOCKET_FRAME_ARENA_HPP__
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief bump allocator for the coroutine frames of one connection
+ *
+ * Frames of nested coroutines come and go in stack order, so freeing the
+ * latest allocation gives its memory straight back; anything else waits
+ * for `reset()` once the request has been answered. Blocks are kept from
+ * one request to the next.
+ */
+class __HttpWebServerSocketPort__ FrameArena
+{
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> memory;
+        size_t                  size;
+        size_t                  used;
+    };
+
+    std::vector<Block> blocks;
+    size_t             current;
+    size_t             block_size;
+
+public:
+    explicit FrameArena(const size_t = 4096);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t);
+
+    /**
+     * @brief give memory back, only the latest allocation is actually reused before a reset
+     */
+    void release(void*, size_t);
+
+    void reset();
+
+    /**
+     * @brief bytes held, used or not
+     */
+    size_t capacity() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_FRAME_ARENA_HPP__ */
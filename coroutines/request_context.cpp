@@ -0,0 +1,293 @@
+#include "request_context.hpp"
+
+#include <cstring>
+
+#include "connection.hpp"
+#include "poller.hpp"
+
+#include "coroutine_handler.hpp"
+
+using namespace nt::http;
+
+RequestContext::BodyAwaiter::BodyAwaiter(RequestContext& owner) :
+      context(owner)
+{
+}
+
+RequestContext::BodyAwaiter::~BodyAwaiter() noexcept
+{
+    if (context.body_waiter == this) {
+        context.body_waiter = nullptr;
+    }
+}
+
+bool
+RequestContext::BodyAwaiter::await_ready() const
+{
+    return context.has_body_ended;
+}
+
+void
+RequestContext::BodyAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+{
+    waiting = coroutine;
+
+    context.wait_for_body(this);
+}
+
+StringView
+RequestContext::BodyAwaiter::await_resume() const
+{
+    return chunk;
+}
+
+RequestContext::SleepAwaiter::SleepAwaiter(RequestContext& owner, const unsigned int duration) :
+      context(owner),
+      milliseconds(duration)
+{
+    command = {nullptr, handle_expired, this};
+}
+
+RequestContext::SleepAwaiter::~SleepAwaiter() noexcept
+{
+    if (timer.is_scheduled()) {
+        context.socket.cancel(&timer);
+    }
+}
+
+void
+RequestContext::SleepAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+{
+    waiting = coroutine;
+
+    context.socket.schedule(&timer, &command, milliseconds);
+}
+
+void
+RequestContext::SleepAwaiter::handle_expired(void* data)
+{
+    auto awaiter = static_cast<SleepAwaiter*>(data);
+
+    awaiter->context.resume(awaiter->waiting);
+}
+
+RequestContext::ReadyAwaiter::ReadyAwaiter(RequestContext& owner, const SOCKET socket, const unsigned int events) :
+      context(owner)
+{
+    watch.socket        = socket;
+    watch.events        = events;
+    watch.ready         = Poller::NONE;
+    watch.is_persistent = false;
+    watch.command       = {nullptr, handle_ready, this};
+}
+
+RequestContext::ReadyAwaiter::~ReadyAwaiter() noexcept
+{
+    context.socket.unwatch(&watch);
+}
+
+void
+RequestContext::ReadyAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+{
+    waiting = coroutine;
+
+    context.socket.watch(&watch);
+}
+
+void
+RequestContext::ReadyAwaiter::handle_ready(void* data)
+{
+    auto awaiter = static_cast<ReadyAwaiter*>(data);
+
+    awaiter->context.resume(awaiter->waiting);
+}
+
+RequestContext::RequestContext(CoroutineHandler& owner, LinuxTcpSocket& loop, const ConnectionHandle& handle) :
+      handler(owner),
+      socket(loop),
+      connection(handle),
+      keep_alive(false),
+      is_head(false),
+      body_waiter(nullptr),
+      has_body_ended(false),
+      is_reading_blocked(false),
+      is_deferred(false),
+      is_closed(false),
+      pending(0)
+{
+    resume_reading = {nullptr, handle_resume_reading, this};
+}
+
+const HttpRequest&
+RequestContext::request() const
+{
+    return current;
+}
+
+ResponseWriter&
+RequestContext::response()
+{
+    return *writer;
+}
+
+const ConnectionHandle&
+RequestContext::handle() const
+{
+    return connection;
+}
+
+FrameArena&
+RequestContext::arena() const
+{
+    return frames;
+}
+
+RequestContext::BodyAwaiter
+RequestContext::body()
+{
+    return BodyAwaiter(*this);
+}
+
+RequestContext::SleepAwaiter
+RequestContext::sleep(const unsigned int milliseconds)
+{
+    return SleepAwaiter(*this, milliseconds);
+}
+
+RequestContext::ReadyAwaiter
+RequestContext::readable(const SOCKET socket)
+{
+    return ReadyAwaiter(*this, socket, Poller::READ);
+}
+
+RequestContext::ReadyAwaiter
+RequestContext::writable(const SOCKET socket)
+{
+    return ReadyAwaiter(*this, socket, Poller::WRITE);
+}
+
+void
+RequestContext::handle_resume_reading(void* data)
+{
+    auto context = static_cast<RequestContext*>(data);
+
+    if (context->returned()) {
+        context->socket.resume(context->connection);
+    }
+}
+
+void
+RequestContext::start(Connection* con, const bool keep_open)
+{
+    const HttpRequest& request = con->parser->request();
+    const char*        head    = con->input.data() + con->consumed;
+
+    // the receive buffer moves on long before a coroutine is done with the request
+    char* copy = static_cast<char*>(frames.allocate(request.size));
+
+    std::memcpy(copy, head, request.size);
+
+    current = request;
+    current.rebase(head, copy);
+
+    keep_alive     = keep_open;
+    is_head        = request.method == "HEAD";
+    has_body_ended = false;
+
+    writer.emplace(output, socket.header_cache(), keep_alive, is_head);
+
+    root = handler.handle(*this);
+
+    resume(root.handle());
+}
+
+void
+RequestContext::resume(std::coroutine_handle<> coroutine)
+{
+    coroutine.resume();
+
+    // before the request is deferred, on_request() picks the response up itself
+    if (!root.is_done() || !is_deferred) {
+        return;
+    }
+
+    settle();
+
+    bool keep_open = writer->is_keep_alive();
+
+    reset();
+
+    // may start the next request on this same context
+    socket.complete(connection, output, keep_open);
+}
+
+bool
+RequestContext::returned()
+{
+    pending--;
+
+    if (!is_closed) {
+        return true;
+    }
+
+    if (pending == 0) {
+        handler.release(this);
+    }
+
+    return false;
+}
+
+void
+RequestContext::deliver(const StringView& chunk)
+{
+    BodyAwaiter* awaiter = body_waiter;
+
+    body_waiter    = nullptr;
+    awaiter->chunk = chunk;
+
+    resume(awaiter->waiting);
+}
+
+void
+RequestContext::wait_for_body(BodyAwaiter* awaiter)
+{
+    body_waiter = awaiter;
+
+    // not from inside on_body(), the socket is in the middle of handing out the body
+    if (is_reading_blocked) {
+        is_reading_blocked = false;
+        pending++;
+
+        socket.post(&resume_reading);
+    }
+}
+
+void
+RequestContext::settle()
+{
+    if (root.has_failed()) {
+        // whatever the handler got to write is dropped, the client cannot tell where it stopped
+        output.clear();
+
+        writer.emplace(output, socket.header_cache(), false, is_head);
+        writer->status(500);
+        writer->end();
+        return;
+    }
+
+    writer->finish();
+}
+
+void
+RequestContext::reset()
+{
+    root = Task();
+
+    writer.reset();
+    frames.reset();
+
+    body_waiter        = nullptr;
+    has_body_ended     = false;
+    is_reading_blocked = false;
+    is_deferred        = false;
+}
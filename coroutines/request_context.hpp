@@ -0,0 +1,331 @@
+#ifndef HTTPWEBSERVER_SOCKET_REQUEST_CONTEXT_HPP__
+#define HTTPWEBSERVER_SOCKET_REQUEST_CONTEXT_HPP__
+
+#include <memory>
+#include <utility>
+#include <optional>
+#include <exception>
+#include <coroutine>
+#include <type_traits>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "string_view.hpp"
+#include "http_parser.hpp"
+#include "output_queue.hpp"
+#include "response_writer.hpp"
+#include "timer_wheel.hpp"
+#include "mailbox.hpp"
+#include "executor.hpp"
+#include "linux_tcp_socket.hpp"
+
+#include "frame_arena.hpp"
+#include "task.hpp"
+
+namespace nt { namespace http {
+
+class CoroutineHandler;
+
+/**
+ * @brief the request a coroutine handler is answering, and what it can wait for
+ *
+ * One per connection, reused by the requests that follow. The request is
+ * a copy kept in the connection's frame arena, the response is written
+ * into a queue of its own and handed to the connection when the handler
+ * returns. Everything here, and every coroutine of the handler, runs on
+ * the loop thread.
+ */
+class __HttpWebServerSocketPort__ RequestContext
+{
+public:
+    /**
+     * @brief the next piece of the request body, empty once it has all been read
+     *
+     * The piece points into the receive buffer and is only valid until the
+     * coroutine suspends again.
+     */
+    class BodyAwaiter
+    {
+    private:
+        RequestContext&         context;
+        StringView              chunk;
+        std::coroutine_handle<> waiting;
+
+        friend class RequestContext;
+        friend class CoroutineHandler;
+
+    public:
+        explicit BodyAwaiter(RequestContext&);
+        ~BodyAwaiter() noexcept;
+
+        BodyAwaiter(const BodyAwaiter&) = delete;
+        BodyAwaiter& operator=(const BodyAwaiter&) = delete;
+
+        bool await_ready() const;
+        void await_suspend(std::coroutine_handle<>);
+        StringView await_resume() const;
+    };
+
+    class SleepAwaiter
+    {
+    private:
+        RequestContext&         context;
+        unsigned int            milliseconds;
+        Timer                   timer;
+        Command                 command;
+        std::coroutine_handle<> waiting;
+
+    public:
+        SleepAwaiter(RequestContext&, const unsigned int);
+        ~SleepAwaiter() noexcept;
+
+        SleepAwaiter(const SleepAwaiter&) = delete;
+        SleepAwaiter& operator=(const SleepAwaiter&) = delete;
+
+        bool
+        await_ready() const
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<>);
+
+        void
+        await_resume() const
+        {
+        }
+
+    private:
+        static void handle_expired(void*);
+    };
+
+    /**
+     * @brief resumes once the descriptor is ready, with the `Poller` events that are
+     */
+    class ReadyAwaiter
+    {
+    private:
+        RequestContext&         context;
+        Watch                   watch;
+        std::coroutine_handle<> waiting;
+
+    public:
+        ReadyAwaiter(RequestContext&, const SOCKET, const unsigned int);
+        ~ReadyAwaiter() noexcept;
+
+        ReadyAwaiter(const ReadyAwaiter&) = delete;
+        ReadyAwaiter& operator=(const ReadyAwaiter&) = delete;
+
+        bool
+        await_ready() const
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<>);
+
+        unsigned int
+        await_resume() const
+        {
+            return watch.ready;
+        }
+
+    private:
+        static void handle_ready(void*);
+    };
+
+    /**
+     * @brief runs a function on an executor worker, resumes on the loop with its result
+     *
+     * Only the function crosses threads, the coroutine stays on the loop.
+     * An exception thrown by the function is thrown again by the await.
+     */
+    template<typename F>
+    class OffloadAwaiter
+    {
+    private:
+        typedef typename std::invoke_result<F&>::type Result;
+
+        struct Work : Job
+        {
+            OffloadAwaiter* owner;
+        };
+
+        RequestContext&         context;
+        Executor&               executor;
+        F                       function;
+        Work                    work;
+        Command                 done;
+        std::coroutine_handle<> waiting;
+        std::exception_ptr      error;
+
+        std::optional<typename std::conditional<std::is_void<Result>::value, bool, Result>::type> result;
+
+    public:
+        OffloadAwaiter(RequestContext& owner, Executor& workers, F&& task) :
+              context(owner),
+              executor(workers),
+              function(std::move(task))
+        {
+            work.next     = nullptr;
+            work.callback = run;
+            work.owner    = this;
+            done          = {nullptr, handle_done, this};
+        }
+
+        OffloadAwaiter(const OffloadAwaiter&) = delete;
+        OffloadAwaiter& operator=(const OffloadAwaiter&) = delete;
+
+        bool
+        await_ready() const
+        {
+            return false;
+        }
+
+        void
+        await_suspend(std::coroutine_handle<> coroutine)
+        {
+            waiting = coroutine;
+
+            // the frame may not go away before the worker is done with it
+            context.pending++;
+            executor.submit(&work);
+        }
+
+        Result
+        await_resume()
+        {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+
+            if constexpr (!std::is_void<Result>::value) {
+                return std::move(*result);
+            }
+        }
+
+    private:
+        static void
+        run(Job* job, const HeaderCache&)
+        {
+            OffloadAwaiter* awaiter = static_cast<Work*>(job)->owner;
+
+            try {
+                if constexpr (std::is_void<Result>::value) {
+                    awaiter->function();
+                    awaiter->result.emplace(true);
+                } else {
+                    awaiter->result.emplace(awaiter->function());
+                }
+            } catch (...) {
+                awaiter->error = std::current_exception();
+            }
+
+            awaiter->context.socket.post(&awaiter->done);
+        }
+
+        static void
+        handle_done(void* data)
+        {
+            auto awaiter = static_cast<OffloadAwaiter*>(data);
+
+            RequestContext& context = awaiter->context;
+
+            if (context.returned()) {
+                context.resume(awaiter->waiting);
+            }
+        }
+    };
+
+private:
+    CoroutineHandler& handler;
+    LinuxTcpSocket&   socket;
+    ConnectionHandle  connection;
+
+    // declared before everything that may live in it
+    mutable FrameArena frames;
+
+    HttpRequest                   current;
+    OutputQueue                   output;
+    std::optional<ResponseWriter> writer;
+    bool                          keep_alive;
+    bool                          is_head;
+
+    BodyAwaiter* body_waiter;
+    bool         has_body_ended;
+    bool         is_reading_blocked;
+    Command      resume_reading;
+
+    /**
+     * @brief whether the connection waits for the response through `complete()`
+     */
+    bool is_deferred;
+    bool is_closed;
+
+    /**
+     * @brief commands and executor jobs that still point into this context
+     */
+    unsigned int pending;
+
+    // destroyed first, its frames refer to everything above
+    Task root;
+
+    friend class CoroutineHandler;
+
+public:
+    RequestContext(CoroutineHandler&, LinuxTcpSocket&, const ConnectionHandle&);
+    ~RequestContext() noexcept = default;
+
+    RequestContext(const RequestContext&) = delete;
+    RequestContext& operator=(const RequestContext&) = delete;
+
+    const HttpRequest& request() const;
+    ResponseWriter& response();
+    const ConnectionHandle& handle() const;
+
+    /**
+     * @brief frames of this connection's coroutines
+     */
+    FrameArena& arena() const;
+
+    BodyAwaiter body();
+    SleepAwaiter sleep(const unsigned int);
+    ReadyAwaiter readable(const SOCKET);
+    ReadyAwaiter writable(const SOCKET);
+
+    template<typename F>
+    OffloadAwaiter<typename std::decay<F>::type>
+    offload(Executor& executor, F&& function)
+    {
+        return OffloadAwaiter<typename std::decay<F>::type>(*this, executor, typename std::decay<F>::type(std::forward<F>(function)));
+    }
+
+private:
+    static void handle_resume_reading(void*);
+
+    void start(Connection*, const bool);
+
+    /**
+     * @brief resume a coroutine of this request, answering it if the handler is done
+     */
+    void resume(std::coroutine_handle<>);
+
+    /**
+     * @brief a command or job pointing here has come back
+     * @return false if the connection is gone, the context may be too
+     */
+    bool returned();
+
+    void deliver(const StringView&);
+    void wait_for_body(BodyAwaiter*);
+
+    /**
+     * @brief finish the response the handler left, a 500 if it threw
+     */
+    void settle();
+    void reset();
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_REQUEST_CONTEXT_HPP__ */
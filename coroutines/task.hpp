@@ -0,0 +1,233 @@
+#ifndef HTTPWEBSERVER_SOCKET_TASK_HPP__
+#define HTTPWEBSERVER_SOCKET_TASK_HPP__
+
+#include <new>
+#include <cstddef>
+#include <exception>
+#include <coroutine>
+#include <type_traits>
+
+#include "frame_arena.hpp"
+
+namespace nt { namespace http {
+
+class RequestContext;
+
+/**
+ * @brief coroutine of a request handler, awaited by its caller
+ *
+ * Starts suspended and runs when awaited, or when the handler starts the
+ * outermost one; on return it resumes its caller directly. An exception
+ * is kept and thrown again in the caller. A coroutine taking a
+ * `RequestContext&` gets its frame from that request's arena, any other
+ * from the heap.
+ */
+class Task
+{
+public:
+    class promise_type
+    {
+    private:
+        // room for the arena pointer without breaking the frame's alignment
+        static const size_t HEADER = alignof(std::max_align_t);
+
+        std::coroutine_handle<> caller;
+        std::exception_ptr      error;
+
+        friend class Task;
+
+        struct FinalAwaiter
+        {
+            bool
+            await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept
+            {
+                std::coroutine_handle<> caller = coroutine.promise().caller;
+
+                return caller ? caller : std::noop_coroutine();
+            }
+
+            void
+            await_resume() const noexcept
+            {
+            }
+        };
+
+    public:
+        Task
+        get_return_object() noexcept
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always
+        initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter
+        final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void
+        return_void() const noexcept
+        {
+        }
+
+        void
+        unhandled_exception() noexcept
+        {
+            error = std::current_exception();
+        }
+
+        template<typename... Args>
+        static void*
+        operator new(size_t size, Args&... args)
+        {
+            return allocate(size, find_arena(args...));
+        }
+
+        static void
+        operator delete(void* frame, size_t size)
+        {
+            char*       memory = static_cast<char*>(frame) - HEADER;
+            FrameArena* arena  = *reinterpret_cast<FrameArena**>(memory);
+
+            if (arena != nullptr) {
+                arena->release(memory, size + HEADER);
+            } else {
+                ::operator delete(memory);
+            }
+        }
+
+    private:
+        static void*
+        allocate(const size_t size, FrameArena* arena)
+        {
+            char* memory = static_cast<char*>(arena != nullptr ? arena->allocate(size + HEADER) :
+                                                                 ::operator new(size + HEADER));
+
+            *reinterpret_cast<FrameArena**>(memory) = arena;
+
+            return memory + HEADER;
+        }
+
+        static FrameArena*
+        find_arena()
+        {
+            return nullptr;
+        }
+
+        // the first context among the arguments, member functions get the object first
+        template<typename T, typename... Rest>
+        static FrameArena*
+        find_arena(T& first, Rest&... rest)
+        {
+            if constexpr (std::is_same<typename std::remove_cv<T>::type, RequestContext>::value) {
+                return &first.arena();
+            } else {
+                return find_arena(rest...);
+            }
+        }
+    };
+
+private:
+    std::coroutine_handle<promise_type> coroutine;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept :
+          coroutine(handle)
+    {
+    }
+
+public:
+    Task() noexcept = default;
+
+    Task(Task&& other) noexcept :
+          coroutine(other.coroutine)
+    {
+        other.coroutine = nullptr;
+    }
+
+    Task&
+    operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (coroutine) {
+                coroutine.destroy();
+            }
+
+            coroutine       = other.coroutine;
+            other.coroutine = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~Task() noexcept
+    {
+        if (coroutine) {
+            coroutine.destroy();
+        }
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool
+    await_ready() const noexcept
+    {
+        return !coroutine || coroutine.done();
+    }
+
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        coroutine.promise().caller = awaiting;
+
+        return coroutine;
+    }
+
+    void
+    await_resume() const
+    {
+        if (coroutine && coroutine.promise().error) {
+            std::rethrow_exception(coroutine.promise().error);
+        }
+    }
+
+    /**
+     * @brief the coroutine itself, for whoever starts the outermost one
+     */
+    std::coroutine_handle<>
+    handle() const noexcept
+    {
+        return coroutine;
+    }
+
+    bool
+    is_done() const noexcept
+    {
+        return coroutine && coroutine.done();
+    }
+
+    /**
+     * @brief whether it ended with an exception
+     */
+    bool
+    has_failed() const noexcept
+    {
+        return is_done() && coroutine.promise().error != nullptr;
+    }
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_TASK_HPP__ */
@@ -0,0 +1,43 @@
+#include "doorbell.hpp"
+
+#include <stdexcept>
+
+#include <sys/eventfd.h>
+
+using namespace nt::http;
+
+Doorbell::Doorbell() :
+      handle(_handle),
+      _handle(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+    if (_handle == -1) {
+        throw std::runtime_error("Failed to create event descriptor.");
+    }
+}
+
+Doorbell::~Doorbell() noexcept
+{
+    ::close(_handle);
+}
+
+void
+Doorbell::ring()
+{
+    uint64_t one = 1;
+
+    // can only fail when the counter would overflow, the loop is awake anyway
+    ssize_t written = ::write(_handle, &one, sizeof(one));
+    (void)written;
+}
+
+uint64_t
+Doorbell::drain()
+{
+    uint64_t count = 0;
+
+    if (::read(_handle, &count, sizeof(count)) != sizeof(count)) {
+        return 0;
+    }
+
+    return count;
+}
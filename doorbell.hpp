@@ -0,0 +1,39 @@
+#ifndef HTTPWEBSERVER_SOCKET_DOORBELL_HPP__
+#define HTTPWEBSERVER_SOCKET_DOORBELL_HPP__
+
+#include <cstdint>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief eventfd used to wake an event loop from another thread
+ */
+class __HttpWebServerSocketPort__ Doorbell
+{
+public:
+    const int& handle;
+private:
+    int _handle;
+
+public:
+    Doorbell();
+    ~Doorbell() noexcept;
+
+    Doorbell(const Doorbell&) = delete;
+    Doorbell& operator=(const Doorbell&) = delete;
+
+    void ring();
+
+    /**
+     * @brief reset the counter
+     * @return number of rings since the last drain
+     */
+    uint64_t drain();
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_DOORBELL_HPP__ */
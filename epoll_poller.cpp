@@ -0,0 +1,154 @@
+#include "epoll_poller.hpp"
+
+#include <stdexcept>
+
+#include <sys/resource.h>
+
+using namespace nt::http;
+
+static inline uint32_t
+_to_epoll_events(unsigned int events)
+{
+    uint32_t flags = 0;
+
+    // a half-close is level triggered, a socket not being read would report it on every wait
+    if (events & Poller::READ) {
+        flags |= EPOLLIN | EPOLLRDHUP;
+    }
+
+    if (events & Poller::WRITE) {
+        flags |= EPOLLOUT;
+    }
+
+    return flags;
+}
+
+static inline unsigned int
+_from_epoll_events(uint32_t flags)
+{
+    unsigned int events = Poller::NONE;
+
+    if (flags & (EPOLLIN | EPOLLRDHUP)) {
+        events |= Poller::READ;
+    }
+
+    if (flags & EPOLLOUT) {
+        events |= Poller::WRITE;
+    }
+
+    if (flags & (EPOLLERR | EPOLLHUP)) {
+        events |= Poller::ERROR;
+    }
+
+    return events;
+}
+
+static inline int
+_to_milliseconds(const Timeval& timeout)
+{
+    const timeval* t = timeout;
+
+    if (t == nullptr) {
+        return -1;
+    }
+
+    return static_cast<int>(t->tv_sec * 1000 + (t->tv_usec + 999) / 1000);
+}
+
+EpollPoller::EpollPoller() :
+      handle(::epoll_create1(EPOLL_CLOEXEC))
+{
+    if (handle == -1) {
+        throw std::runtime_error("Failed to create epoll instance.");
+    }
+}
+
+EpollPoller::~EpollPoller() noexcept
+{
+    ::close(handle);
+}
+
+void
+EpollPoller::add(SOCKET socket, unsigned int events, void* user_data)
+{
+    epoll_event event = {0};
+
+    event.events  = _to_epoll_events(events);
+    event.data.fd = socket;
+
+    if (::epoll_ctl(handle, EPOLL_CTL_ADD, socket, &event) == -1) {
+        throw std::runtime_error("Failed to register socket for polling.");
+    }
+
+    if (data.size() <= static_cast<size_t>(socket)) {
+        data.resize(socket + 1, nullptr);
+    }
+
+    data[socket] = user_data;
+}
+
+void
+EpollPoller::modify(SOCKET socket, unsigned int events, void* user_data)
+{
+    epoll_event event = {0};
+
+    event.events  = _to_epoll_events(events);
+    event.data.fd = socket;
+
+    if (::epoll_ctl(handle, EPOLL_CTL_MOD, socket, &event) == -1) {
+        throw std::runtime_error("Failed to update polled socket.");
+    }
+
+    data[socket] = user_data;
+}
+
+void
+EpollPoller::remove(SOCKET socket)
+{
+    // a socket that is already closed has left the set on its own
+    ::epoll_ctl(handle, EPOLL_CTL_DEL, socket, nullptr);
+
+    if (static_cast<size_t>(socket) < data.size()) {
+        data[socket] = nullptr;
+    }
+}
+
+int
+EpollPoller::wait(PollEvent* events, const int count, const Timeval& timeout)
+{
+    if (ready.size() < static_cast<size_t>(count)) {
+        ready.resize(count);
+    }
+
+    int wait_result = ::epoll_wait(handle, ready.data(), count, _to_milliseconds(timeout));
+
+    if (wait_result == -1) {
+        if (errno == EINTR) {
+            return 0;
+        }
+
+        throw std::runtime_error("Failed to poll connections.");
+    }
+
+    for (int i = 0; i < wait_result; i++) {
+        SOCKET socket = ready[i].data.fd;
+
+        events[i].socket = socket;
+        events[i].events = _from_epoll_events(ready[i].events);
+        events[i].data   = data[socket];
+    }
+
+    return wait_result;
+}
+
+unsigned int
+EpollPoller::capacity() const
+{
+    rlimit limit = {0};
+
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+        return 1 << 20;
+    }
+
+    return static_cast<unsigned int>(limit.rlim_cur);
+}
@@ -0,0 +1,35 @@
+#ifndef HTTPWEBSERVER_SOCKET_EPOLL_POLLER_HPP__
+#define HTTPWEBSERVER_SOCKET_EPOLL_POLLER_HPP__
+
+#include <vector>
+
+#include <sys/epoll.h>
+
+#include "common.hpp"
+#include "poller.hpp"
+
+namespace nt { namespace http {
+
+class __HttpWebServerSocketPort__ EpollPoller :
+      public Poller
+{
+private:
+    int handle;
+
+    std::vector<epoll_event> ready;
+    std::vector<void*>       data;
+
+public:
+    EpollPoller();
+    ~EpollPoller() noexcept;
+
+    void add(SOCKET, unsigned int, void*);
+    void modify(SOCKET, unsigned int, void*);
+    void remove(SOCKET);
+    int wait(PollEvent*, const int, const Timeval&);
+    unsigned int capacity() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_EPOLL_POLLER_HPP__ */
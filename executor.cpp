@@ -0,0 +1,232 @@
+#include "executor.hpp"
+
+#include <tinythread.h>
+#include <poll.h>
+
+#include <macros/leave_loop_if.hpp>
+
+using namespace nt::http;
+
+namespace {
+
+unsigned int
+_get_worker_count(const unsigned int count)
+{
+    if (count != 0) {
+        return count;
+    }
+
+    unsigned int cores = tthread::thread::hardware_concurrency();
+
+    return cores == 0 ? 1 : cores;
+}
+
+}
+
+Executor::Worker::Worker(Executor* owner, const size_t position) :
+      executor(owner),
+      index(position),
+      is_sleeping(false)
+{
+}
+
+Executor::Executor(const unsigned int count) :
+      next_worker(0),
+      stopping(false)
+{
+    unsigned int worker_count = _get_worker_count(count);
+
+    workers.reserve(worker_count);
+
+    for (unsigned int i = 0; i < worker_count; i++) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker(this, i)));
+    }
+
+    for (auto& worker : workers) {
+        threads.push_back(std::unique_ptr<tthread::thread>(new tthread::thread(run_worker, worker.get())));
+    }
+}
+
+Executor::~Executor() noexcept
+{
+    stopping.store(true);
+
+    for (auto& worker : workers) {
+        worker->doorbell.ring();
+    }
+
+    for (auto& thread : threads) {
+        if (thread->joinable()) {
+            thread->join();
+        }
+    }
+}
+
+void
+Executor::submit(Job* job)
+{
+    Worker* target = nullptr;
+
+    // an idle worker starts at once, otherwise the job waits its turn somewhere
+    for (auto& worker : workers) {
+        if (worker->is_sleeping.load(std::memory_order_relaxed)) {
+            target = worker.get();
+            break;
+        }
+    }
+
+    bool is_busy = target == nullptr;
+
+    if (is_busy) {
+        target = workers[next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size()].get();
+    }
+
+    // a non-empty inbox is looked at before the worker sleeps again
+    if (target->inbox.push(job)) {
+        target->doorbell.ring();
+    }
+
+    // a worker gone idle since the look above can take it from the busy one
+    if (is_busy) {
+        wake_idle();
+    }
+}
+
+unsigned int
+Executor::size() const
+{
+    return workers.size();
+}
+
+void
+Executor::run_worker(void* arg)
+{
+    auto      worker   = static_cast<Worker*>(arg);
+    Executor* executor = worker->executor;
+
+    while (true) {
+        Job* job = executor->next_job(worker);
+
+        if (job == nullptr) {
+            if (executor->stopping.load()) {
+                break;
+            }
+
+            job = executor->sleep(worker);
+
+            continue_if (job == nullptr);
+        }
+
+        worker->clock.update();
+        worker->headers.update(worker->clock.now());
+
+        job->callback(job, worker->headers);
+    }
+}
+
+Job*
+Executor::next_job(Worker* worker)
+{
+    Job* job = worker->deque.pop();
+
+    if (job != nullptr) {
+        return job;
+    }
+
+    Job* batch = worker->inbox.pop_all();
+
+    if (batch == nullptr) {
+        return steal(worker);
+    }
+
+    return adopt(worker, batch);
+}
+
+Job*
+Executor::steal(Worker* worker)
+{
+    size_t count = workers.size();
+
+    for (size_t i = 1; i < count; i++) {
+        Worker* victim = workers[(worker->index + i) % count].get();
+        Job*    job    = victim->deque.steal();
+
+        if (job != nullptr) {
+            return job;
+        }
+
+        // the victim may be busy with a long job, it only empties its inbox between jobs
+        Job* batch = victim->inbox.pop_all();
+
+        if (batch != nullptr) {
+            return adopt(worker, batch);
+        }
+    }
+
+    return nullptr;
+}
+
+Job*
+Executor::adopt(Worker* worker, Job* batch)
+{
+    // newest first, so the owner pops the oldest and thieves take the newest
+    Job*   reversed = nullptr;
+    size_t count    = 0;
+
+    while (batch != nullptr) {
+        Job* next = batch->next;
+
+        batch->next = reversed;
+        reversed    = batch;
+        batch       = next;
+        count++;
+    }
+
+    while (reversed != nullptr) {
+        Job* next = reversed->next;
+
+        worker->deque.push(reversed);
+        reversed = next;
+    }
+
+    if (count > 1) {
+        wake_idle();
+    }
+
+    return worker->deque.pop();
+}
+
+Job*
+Executor::sleep(Worker* worker)
+{
+    // reset the counter first, a submit racing with this either lands in
+    // the check below or finds the inbox empty and rings again
+    worker->doorbell.drain();
+    worker->is_sleeping.store(true);
+
+    Job* job = next_job(worker);
+
+    if (job == nullptr && !stopping.load()) {
+        pollfd ready = {worker->doorbell.handle, POLLIN, 0};
+
+        ::poll(&ready, 1, -1);
+    }
+
+    worker->is_sleeping.store(false);
+
+    return job;
+}
+
+void
+Executor::wake_idle()
+{
+    // pairs with the store in sleep(), either the sleeper sees the new jobs or this sees the sleeper
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    for (auto& worker : workers) {
+        if (worker->is_sleeping.load()) {
+            worker->doorbell.ring();
+            return;
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef HTTPWEBSERVER_SOCKET_EXECUTOR_HPP__
+#define HTTPWEBSERVER_SOCKET_EXECUTOR_HPP__
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "mpsc_queue.hpp"
+#include "work_stealing_deque.hpp"
+#include "doorbell.hpp"
+#include "loop_clock.hpp"
+#include "header_cache.hpp"
+
+namespace tthread {
+class thread;
+}
+
+namespace nt { namespace http {
+
+struct Job;
+
+typedef void (* job_callback)(Job*, const HeaderCache&);
+
+/**
+ * @brief work handed to an Executor
+ *
+ * The submitter owns the job and keeps it alive until `callback` has run
+ * on a worker thread; the callback may free it or post it on. It is given
+ * the worker's `Server` and `Date` lines for the response it writes.
+ */
+struct Job
+{
+    Job*         next;
+    job_callback callback;
+};
+
+/**
+ * @brief worker threads for request handlers too slow to run on an event loop
+ *
+ * Every worker owns a Chase-Lev deque and takes from its bottom, idle
+ * workers steal from the top of the others'. Submitting never blocks: a
+ * job goes to a sleeping worker's inbox if there is one, else round robin,
+ * and the worker's doorbell is only rung when the inbox was empty. An
+ * inbox is moved into the deque before its jobs run, and a thief finding
+ * a deque empty takes the inbox of a worker stuck on a long job, so jobs
+ * never wait behind it.
+ */
+class __HttpWebServerSocketPort__ Executor
+{
+private:
+    struct Worker
+    {
+        Executor* executor;
+        size_t    index;
+
+        WorkStealingDeque<Job> deque;
+        MpscQueue<Job>         inbox;
+        Doorbell               doorbell;
+        std::atomic<bool>      is_sleeping;
+
+        LoopClock   clock;
+        HeaderCache headers;
+
+        Worker(Executor*, const size_t);
+    };
+
+    std::vector<std::unique_ptr<Worker>>          workers;
+    std::vector<std::unique_ptr<tthread::thread>> threads;
+
+    std::atomic<size_t> next_worker;
+    std::atomic<bool>   stopping;
+
+public:
+    /**
+     * @param count number of worker threads, 0 for the hardware concurrency
+     */
+    explicit Executor(const unsigned int = 0);
+
+    /**
+     * @brief runs the jobs already submitted, then joins the workers
+     */
+    ~Executor() noexcept;
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief run a job on some worker, safe from any thread
+     */
+    void submit(Job*);
+
+    unsigned int size() const;
+
+private:
+    static void run_worker(void*);
+
+    Job* next_job(Worker*);
+    Job* steal(Worker*);
+
+    /**
+     * @brief move a batch taken from an inbox into the worker's deque
+     * @return the oldest job of the batch
+     */
+    Job* adopt(Worker*, Job*);
+
+    /**
+     * @brief wait for the doorbell, unless a last look finds a job
+     */
+    Job* sleep(Worker*);
+    void wake_idle();
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_EXECUTOR_HPP__ */
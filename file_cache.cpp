@@ -0,0 +1,101 @@
+#include <fcntl.h>
+
+#include "file_cache.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const size_t   MAX_ENTRIES = 1024;
+const uint64_t INTERVAL    = 1000;
+
+}
+
+FileCache::FileCache() :
+      FileCache(MAX_ENTRIES, INTERVAL)
+{
+}
+
+FileCache::FileCache(const size_t count, const uint64_t milliseconds) :
+      max_entries(count),
+      interval(milliseconds)
+{
+}
+
+std::shared_ptr<const OpenFile>
+FileCache::open(const std::string& path, const uint64_t now)
+{
+    auto found = entries.find(path);
+
+    if (found != entries.end() && now - found->second.checked < interval) {
+        return found->second.file;
+    }
+
+    struct stat info;
+
+    if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        if (found != entries.end()) {
+            entries.erase(found);
+        }
+
+        return nullptr;
+    }
+
+    if (found != entries.end() && found->second.file->is_current(info)) {
+        found->second.checked = now;
+
+        return found->second.file;
+    }
+
+    int handle = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    // described by what was opened, the path may have been replaced since the stat
+    if (handle == -1 || ::fstat(handle, &info) != 0) {
+        if (handle != -1) {
+            ::close(handle);
+        }
+
+        if (found != entries.end()) {
+            entries.erase(found);
+        }
+
+        return nullptr;
+    }
+
+    auto file = std::make_shared<const OpenFile>(handle, info);
+
+    if (found != entries.end()) {
+        found->second = {file, now};
+    } else {
+        if (entries.size() >= max_entries) {
+            evict();
+        }
+
+        entries.emplace(path, Entry{file, now});
+    }
+
+    return file;
+}
+
+void
+FileCache::evict()
+{
+    // only when full, the entry that has gone longest without a check goes
+    auto oldest = entries.begin();
+
+    for (auto entry = entries.begin(); entry != entries.end(); ++entry) {
+        if (entry->second.checked < oldest->second.checked) {
+            oldest = entry;
+        }
+    }
+
+    if (oldest != entries.end()) {
+        entries.erase(oldest);
+    }
+}
+
+size_t
+FileCache::size() const
+{
+    return entries.size();
+}
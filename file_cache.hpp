@@ -0,0 +1,63 @@
+#ifndef HTTPWEBSERVER_SOCKET_FILE_CACHE_HPP__
+#define HTTPWEBSERVER_SOCKET_FILE_CACHE_HPP__
+
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "open_file.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief open descriptors and inode metadata of recently served files, by path
+ *
+ * An entry is trusted for a short interval and checked against a fresh
+ * `stat` after that; a file that changed is opened again, one that went
+ * away is dropped. Responses still being sent keep their file open after
+ * it has left the cache. Not thread safe, every loop has its own.
+ */
+class __HttpWebServerSocketPort__ FileCache
+{
+private:
+    struct Entry
+    {
+        std::shared_ptr<const OpenFile> file;
+        uint64_t                        checked;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+
+    size_t   max_entries;
+    uint64_t interval;
+
+public:
+    FileCache();
+
+    /**
+     * @param max_entries files kept open at most
+     * @param interval milliseconds an entry is used without checking the file
+     */
+    FileCache(const size_t, const uint64_t);
+
+    FileCache(const FileCache&) = delete;
+    FileCache& operator=(const FileCache&) = delete;
+
+    /**
+     * @brief the regular file at `path`, nullptr if there is none or it cannot be read
+     * @param now milliseconds on the loop clock
+     */
+    std::shared_ptr<const OpenFile> open(const std::string&, const uint64_t);
+
+    size_t size() const;
+
+private:
+    void evict();
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_FILE_CACHE_HPP__ */
@@ -0,0 +1,26 @@
+#ifndef HTTPWEBSERVER_SOCKET_HANDOFF_HPP__
+#define HTTPWEBSERVER_SOCKET_HANDOFF_HPP__
+
+#include "common.hpp"
+#include "spsc_queue.hpp"
+#include "doorbell.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief accepted sockets travelling from the acceptor to one worker
+ */
+struct Handoff
+{
+    SpscQueue<SOCKET> queue;
+    Doorbell          doorbell;
+
+    explicit Handoff(const size_t capacity) :
+          queue(capacity)
+    {
+    }
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_HANDOFF_HPP__ */
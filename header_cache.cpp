@@ -0,0 +1,112 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "header_cache.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const char SERVER[] = "Server: httpwebserver\r\n";
+
+struct StatusLine
+{
+    unsigned int code;
+    const char*  line;
+    size_t       size;
+};
+
+#define STATUS_LINE(code, text) {code, text, sizeof(text) - 1}
+
+const StatusLine STATUS_LINES[] = {
+    STATUS_LINE(100, "HTTP/1.1 100 Continue\r\n"),
+    STATUS_LINE(200, "HTTP/1.1 200 OK\r\n"),
+    STATUS_LINE(201, "HTTP/1.1 201 Created\r\n"),
+    STATUS_LINE(204, "HTTP/1.1 204 No Content\r\n"),
+    STATUS_LINE(206, "HTTP/1.1 206 Partial Content\r\n"),
+    STATUS_LINE(301, "HTTP/1.1 301 Moved Permanently\r\n"),
+    STATUS_LINE(302, "HTTP/1.1 302 Found\r\n"),
+    STATUS_LINE(304, "HTTP/1.1 304 Not Modified\r\n"),
+    STATUS_LINE(400, "HTTP/1.1 400 Bad Request\r\n"),
+    STATUS_LINE(403, "HTTP/1.1 403 Forbidden\r\n"),
+    STATUS_LINE(404, "HTTP/1.1 404 Not Found\r\n"),
+    STATUS_LINE(405, "HTTP/1.1 405 Method Not Allowed\r\n"),
+    STATUS_LINE(413, "HTTP/1.1 413 Payload Too Large\r\n"),
+    STATUS_LINE(416, "HTTP/1.1 416 Range Not Satisfiable\r\n"),
+    STATUS_LINE(500, "HTTP/1.1 500 Internal Server Error\r\n"),
+    STATUS_LINE(503, "HTTP/1.1 503 Service Unavailable\r\n"),
+};
+
+#undef STATUS_LINE
+
+}
+
+HeaderCache::HeaderCache() :
+      host_size(0),
+      block_size(0),
+      second(UINT64_MAX)
+{
+    if (::gethostname(host, HOST_SIZE - 1) == SOCKET_ERROR) {
+        throw std::runtime_error("Failed to get host name.");
+    }
+
+    host[HOST_SIZE - 1] = '\0';
+    host_size = std::strlen(host);
+
+    format_date(std::time(nullptr));
+}
+
+void
+HeaderCache::update(const uint64_t now)
+{
+    // the loop clock is monotonic, it only says when the wall clock is worth reading
+    if (now / 1000 != second) {
+        second = now / 1000;
+
+        format_date(std::time(nullptr));
+    }
+}
+
+void
+HeaderCache::format_date(const std::time_t now)
+{
+    std::tm utc;
+
+#ifdef LOSE
+    ::gmtime_s(&utc, &now);
+#else
+    ::gmtime_r(&now, &utc);
+#endif
+
+    std::memcpy(block, SERVER, sizeof(SERVER) - 1);
+
+    block_size  = sizeof(SERVER) - 1;
+    block_size += std::strftime(block + block_size,
+                                BLOCK_SIZE - block_size,
+                                "Date: %a, %d %b %Y %H:%M:%S GMT\r\n",
+                                &utc);
+}
+
+StringView
+HeaderCache::server_headers() const
+{
+    return StringView(block, block_size);
+}
+
+StringView
+HeaderCache::hostname() const
+{
+    return StringView(host, host_size);
+}
+
+StringView
+HeaderCache::status_line(const unsigned int code)
+{
+    for (const auto& status : STATUS_LINES) {
+        if (status.code == code) {
+            return StringView(status.line, status.size);
+        }
+    }
+
+    return StringView();
+}
@@ -0,0 +1,63 @@
+#ifndef HTTPWEBSERVER_SOCKET_HEADER_CACHE_HPP__
+#define HTTPWEBSERVER_SOCKET_HEADER_CACHE_HPP__
+
+#include <cstdint>
+#include <ctime>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "string_view.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief response header lines that are the same for every response of one event loop
+ *
+ * The host name is looked up once, the `Server` and `Date` lines are kept
+ * serialized and only reformatted when the second changes. Not thread
+ * safe, every loop has its own.
+ */
+class __HttpWebServerSocketPort__ HeaderCache
+{
+private:
+    static const size_t HOST_SIZE  = HOST_NAME_MAX + 1;
+    static const size_t BLOCK_SIZE = 96;
+
+    char   host[HOST_SIZE];
+    size_t host_size;
+
+    char   block[BLOCK_SIZE];
+    size_t block_size;
+
+    uint64_t second;
+
+public:
+    HeaderCache();
+
+    HeaderCache(const HeaderCache&) = delete;
+    HeaderCache& operator=(const HeaderCache&) = delete;
+
+    /**
+     * @brief reformat the `Date` line if `now`, in milliseconds, is in a new second
+     */
+    void update(const uint64_t);
+
+    /**
+     * @brief `Server` and `Date` lines, each ending in CRLF
+     */
+    StringView server_headers() const;
+
+    StringView hostname() const;
+
+    /**
+     * @brief serialized `HTTP/1.1 <code> <reason>` line with its CRLF, empty for unusual codes
+     */
+    static StringView status_line(const unsigned int);
+
+private:
+    void format_date(const std::time_t);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_HEADER_CACHE_HPP__ */
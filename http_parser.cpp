@@ -0,0 +1,324 @@
+#include "http_parser.hpp"
+
+#include <cstring>
+
+#include <utility/scan.hpp>
+
+using namespace nt::http;
+
+namespace {
+
+inline bool
+_is_space(const char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * @brief HTTP/1.1 is persistent unless told otherwise, HTTP/1.0 only on request
+ */
+bool
+_is_keep_alive(const HttpRequest& request)
+{
+    bool keep_alive = request.minor_version >= 1;
+
+    for (unsigned int i = 0; i < request.header_count; i++) {
+        const HttpHeader& header = request.headers[i];
+
+        if (!header.name.equals_ignore_case("connection")) {
+            continue;
+        }
+
+        const StringView& value = header.value;
+
+        for (size_t from = 0; from < value.size();) {
+            size_t comma = value.find(',', from);
+            size_t to    = comma == StringView::npos ? value.size() : comma;
+
+            while (from < to && _is_space(value[from])) {
+                from++;
+            }
+
+            size_t last = to;
+
+            while (last > from && _is_space(value[last - 1])) {
+                last--;
+            }
+
+            StringView token = value.substr(from, last - from);
+
+            if (token.equals_ignore_case("close")) {
+                keep_alive = false;
+            } else if (token.equals_ignore_case("keep-alive")) {
+                keep_alive = true;
+            }
+
+            from = to + 1;
+        }
+    }
+
+    return keep_alive;
+}
+
+}
+
+const HttpHeader*
+HttpRequest::find_header(const StringView& name) const
+{
+    for (unsigned int i = 0; i < header_count; i++) {
+        if (headers[i].name.equals_ignore_case(name)) {
+            return &headers[i];
+        }
+    }
+
+    return nullptr;
+}
+
+void
+HttpRequest::rebase(const char* from, const char* to)
+{
+    auto move = [from, to](StringView& view) {
+        if (view.data() != nullptr) {
+            view = StringView(to + (view.data() - from), view.size());
+        }
+    };
+
+    move(method);
+    move(target);
+    move(version);
+
+    for (unsigned int i = 0; i < header_count; i++) {
+        move(headers[i].name);
+        move(headers[i].value);
+    }
+}
+
+HttpParser::HttpParser(const size_t max_head_size) :
+      limit(max_head_size)
+{
+    reset();
+}
+
+void
+HttpParser::reset()
+{
+    state        = State::Start;
+    base         = nullptr;
+    position     = 0;
+    mark         = 0;
+    header_count = 0;
+
+    parsed.header_count = 0;
+    parsed.size         = 0;
+}
+
+const HttpRequest&
+HttpParser::request() const
+{
+    return parsed;
+}
+
+HttpParser::Result
+HttpParser::fail()
+{
+    state = State::Failed;
+
+    return Result::Error;
+}
+
+HttpParser::Result
+HttpParser::parse(const char* buffer, const size_t size)
+{
+    if (state == State::Done) {
+        if (buffer != base) {
+            complete(buffer);
+        }
+
+        return Result::Complete;
+    } else if (state == State::Failed) {
+        return Result::Error;
+    }
+
+    size_t end = size < limit ? size : limit;
+
+    while (position < end) {
+        switch (state) {
+        case State::Start:
+            // tolerate the stray CRLF some clients send after a body
+            if (buffer[position] == '\r' || buffer[position] == '\n') {
+                position++;
+                break;
+            }
+
+            mark  = position;
+            state = State::Method;
+            break;
+
+        case State::Method:
+            position += utility::scan::find_non_token(buffer + position, end - position);
+
+            if (position == end) {
+                break;
+            } else if (buffer[position] != ' ' || position == mark) {
+                return fail();
+            }
+
+            method = {mark, position - mark};
+            mark   = ++position;
+            state  = State::Target;
+            break;
+
+        case State::Target:
+            position += utility::scan::find_non_target(buffer + position, end - position);
+
+            if (position == end) {
+                break;
+            } else if (buffer[position] != ' ' || position == mark) {
+                return fail();
+            }
+
+            target = {mark, position - mark};
+            mark   = ++position;
+            state  = State::Version;
+            break;
+
+        case State::Version:
+            // "HTTP/1.x" is all we speak
+            while (position < end && buffer[position] != '\r' && position - mark < 8) {
+                position++;
+            }
+
+            if (position == end) {
+                break;
+            } else if (buffer[position] != '\r' ||
+                       position - mark != 8 ||
+                       std::memcmp(buffer + mark, "HTTP/1.", 7) != 0 ||
+                       buffer[mark + 7] < '0' || buffer[mark + 7] > '9') {
+                return fail();
+            }
+
+            version = {mark, 8};
+            position++;
+            state = State::RequestLineEnd;
+            break;
+
+        case State::RequestLineEnd:
+            if (buffer[position++] != '\n') {
+                return fail();
+            }
+
+            state = State::HeaderStart;
+            break;
+
+        case State::HeaderStart:
+            if (buffer[position] == '\r') {
+                position++;
+                state = State::HeadEnd;
+                break;
+            } else if (header_count == HttpRequest::MAX_HEADERS) {
+                return fail();
+            }
+
+            mark  = position;
+            state = State::HeaderName;
+            break;
+
+        case State::HeaderName:
+            position += utility::scan::find_non_token(buffer + position, end - position);
+
+            // no white space before the colon and no folded lines
+            if (position == end) {
+                break;
+            } else if (buffer[position] != ':' || position == mark) {
+                return fail();
+            }
+
+            names[header_count] = {mark, position - mark};
+            position++;
+            state = State::HeaderValueStart;
+            break;
+
+        case State::HeaderValueStart:
+            while (position < end && _is_space(buffer[position])) {
+                position++;
+            }
+
+            if (position == end) {
+                break;
+            }
+
+            mark  = position;
+            state = State::HeaderValue;
+            break;
+
+        case State::HeaderValue:
+            position += utility::scan::find_non_value(buffer + position, end - position);
+
+            if (position == end) {
+                break;
+            } else if (buffer[position] != '\r') {
+                return fail();
+            } else {
+                size_t last = position;
+
+                while (last > mark && _is_space(buffer[last - 1])) {
+                    last--;
+                }
+
+                values[header_count++] = {mark, last - mark};
+            }
+
+            position++;
+            state = State::HeaderLineEnd;
+            break;
+
+        case State::HeaderLineEnd:
+            if (buffer[position++] != '\n') {
+                return fail();
+            }
+
+            state = State::HeaderStart;
+            break;
+
+        case State::HeadEnd:
+            if (buffer[position++] != '\n') {
+                return fail();
+            }
+
+            complete(buffer);
+
+            return Result::Complete;
+
+        default:
+            return fail();
+        }
+    }
+
+    if (position >= limit) {
+        return fail();
+    }
+
+    return Result::Incomplete;
+}
+
+void
+HttpParser::complete(const char* buffer)
+{
+    base = buffer;
+
+    parsed.method  = StringView(buffer + method.offset, method.size);
+    parsed.target  = StringView(buffer + target.offset, target.size);
+    parsed.version = StringView(buffer + version.offset, version.size);
+
+    for (unsigned int i = 0; i < header_count; i++) {
+        parsed.headers[i].name  = StringView(buffer + names[i].offset, names[i].size);
+        parsed.headers[i].value = StringView(buffer + values[i].offset, values[i].size);
+    }
+
+    parsed.header_count  = header_count;
+    parsed.minor_version = static_cast<unsigned int>(buffer[version.offset + 7] - '0');
+    parsed.size          = position;
+    parsed.keep_alive    = _is_keep_alive(parsed);
+
+    state = State::Done;
+}
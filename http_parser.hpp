@@ -0,0 +1,145 @@
+#ifndef HTTPWEBSERVER_SOCKET_HTTP_PARSER_HPP__
+#define HTTPWEBSERVER_SOCKET_HTTP_PARSER_HPP__
+
+#include <cstddef>
+
+#include "common.hpp"
+#include "string_view.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+struct HttpHeader
+{
+    StringView name;
+    StringView value;
+};
+
+/**
+ * @brief a parsed request head, every view points into the receive buffer
+ */
+struct HttpRequest
+{
+    static const unsigned int MAX_HEADERS = 32;
+
+    StringView method;
+    StringView target;
+    StringView version;
+
+    HttpHeader   headers[MAX_HEADERS];
+    unsigned int header_count;
+
+    unsigned int minor_version;
+    bool         keep_alive;
+
+    /**
+     * @brief bytes taken by the request line and headers, including the blank line
+     */
+    size_t size;
+
+    /**
+     * @brief first header with the given name, case insensitive
+     * @return nullptr when there is none
+     */
+    const HttpHeader* find_header(const StringView&) const;
+
+    /**
+     * @brief point every view at a copy of the head, `from` and `to` being where the head starts
+     */
+    void rebase(const char*, const char*);
+};
+
+/**
+ * @brief resumable HTTP/1.x request head parser
+ *
+ * `parse()` is handed the whole receive buffer every time and carries on
+ * from where the previous call ran out of data, so no byte is looked at
+ * twice. Only offsets are kept while parsing, the buffer may be moved
+ * (e.g. grow) between calls as long as its contents stay. Views are made
+ * once the head is complete.
+ */
+class __HttpWebServerSocketPort__ HttpParser
+{
+public:
+    enum class Result
+    {
+        Incomplete,
+        Complete,
+        Error
+    };
+
+    static const size_t MAX_HEAD_SIZE = 8192;
+
+private:
+    struct Range
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    enum class State : unsigned char
+    {
+        Start,
+        Method,
+        Target,
+        Version,
+        RequestLineEnd,
+        HeaderStart,
+        HeaderName,
+        HeaderValueStart,
+        HeaderValue,
+        HeaderLineEnd,
+        HeadEnd,
+        Done,
+        Failed
+    };
+
+    State       state;
+    const char* base;
+    size_t      position;
+    size_t mark;
+    size_t limit;
+
+    Range method;
+    Range target;
+    Range version;
+    Range names[HttpRequest::MAX_HEADERS];
+    Range values[HttpRequest::MAX_HEADERS];
+
+    unsigned int header_count;
+
+    HttpRequest parsed;
+
+public:
+    /**
+     * @param max_head_size longest request head accepted before failing
+     */
+    explicit HttpParser(const size_t limit = MAX_HEAD_SIZE);
+
+    /**
+     * @brief forget the current request, call before parsing the next one
+     */
+    void reset();
+
+    /**
+     * @param buffer start of the request, with everything received so far
+     * @param size   bytes in the buffer, never fewer than in the previous call
+     */
+    Result parse(const char*, const size_t);
+
+    /**
+     * @brief the request head, valid after `Complete` until the buffer changes
+     *
+     * Parsing a completed request again only points the views at the
+     * buffer passed, in case it moved.
+     */
+    const HttpRequest& request() const;
+
+private:
+    Result fail();
+    void complete(const char*);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_HTTP_PARSER_HPP__ */
@@ -0,0 +1,6 @@
+
+#include "body_handler.hpp"
+
+using namespace nt::http::interfaces;
+
+BodyHandler::~BodyHandler() noexcept = default;
@@ -0,0 +1,42 @@
+#ifndef HTTPWEBSERVER_SOCKET_HPP_INTERFACE_BODY_HANDLER__
+#define HTTPWEBSERVER_SOCKET_HPP_INTERFACE_BODY_HANDLER__
+
+#include <cstddef>
+
+#include "socket.hpp"
+#include "../string_view.hpp"
+
+namespace nt { namespace http {
+
+class Connection;
+
+namespace interfaces {
+
+/**
+ * @brief receives request bodies piece by piece, on the event loop thread
+ *
+ * Slices point into the connection's receive buffer and are only valid
+ * during the call. Taking fewer bytes than offered stops reading from
+ * that connection until the socket's `resume()` is called with its
+ * `handle`; the rest is offered again then.
+ */
+class __HttpWebServerSocketPort__ BodyHandler
+{
+public:
+    BodyHandler() = default;
+    virtual ~BodyHandler() noexcept = 0;
+
+    /**
+     * @return number of bytes taken from the front of the slice
+     */
+    virtual size_t on_body(Connection*, const StringView&) = 0;
+
+    /**
+     * @brief the whole body has been handed over
+     */
+    virtual void on_body_end(Connection*) = 0;
+};
+
+}}}
+
+#endif /* HTTPWEBSERVER_SOCKET_HPP_INTERFACE_BODY_HANDLER__ */
@@ -0,0 +1,5 @@
+#include "datagram_handler.hpp"
+
+using namespace nt::http::interfaces;
+
+DatagramHandler::~DatagramHandler() noexcept = default;
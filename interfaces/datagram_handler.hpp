@@ -0,0 +1,33 @@
+#ifndef HTTPWEBSERVER_SOCKET_HPP_INTERFACE_DATAGRAM_HANDLER__
+#define HTTPWEBSERVER_SOCKET_HPP_INTERFACE_DATAGRAM_HANDLER__
+
+#include <cstddef>
+
+#include "socket.hpp"
+
+namespace nt { namespace http {
+
+class UdpSocket;
+struct Datagram;
+
+namespace interfaces {
+
+/**
+ * @brief receives datagrams a batch at a time, on the event loop thread
+ *
+ * The datagrams point into the socket's receive buffers and are only
+ * valid during the call. Replies queued with the socket's `send()`
+ * during the call go out together once it returns.
+ */
+class __HttpWebServerSocketPort__ DatagramHandler
+{
+public:
+    DatagramHandler() = default;
+    virtual ~DatagramHandler() noexcept = 0;
+
+    virtual void on_datagrams(UdpSocket&, const Datagram*, const size_t) = 0;
+};
+
+}}}
+
+#endif /* HTTPWEBSERVER_SOCKET_HPP_INTERFACE_DATAGRAM_HANDLER__ */
@@ -0,0 +1,16 @@
+#include "request_handler.hpp"
+
+using namespace nt::http::interfaces;
+
+RequestHandler::~RequestHandler() noexcept = default;
+
+bool
+RequestHandler::is_cpu_bound(const HttpRequest&) const
+{
+    return false;
+}
+
+void
+RequestHandler::on_close(Connection*)
+{
+}
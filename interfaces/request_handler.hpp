@@ -0,0 +1,51 @@
+#ifndef HTTPWEBSERVER_SOCKET_HPP_INTERFACE_REQUEST_HANDLER__
+#define HTTPWEBSERVER_SOCKET_HPP_INTERFACE_REQUEST_HANDLER__
+
+#include "socket.hpp"
+
+namespace nt { namespace http {
+
+class Connection;
+class ResponseWriter;
+struct HttpRequest;
+
+namespace interfaces {
+
+/**
+ * @brief answers requests, on the event loop thread
+ *
+ * The request's views point into the connection's receive buffer and the
+ * writer appends to its output queue, neither outlives the call. Whatever
+ * the handler leaves unfinished is completed when it returns: no response
+ * at all becomes a 500, an open head gets an empty body.
+ *
+ * Requests the handler says are CPU bound run on the socket's executor,
+ * if it has one, with a copy of the request and no connection; the
+ * handler must then be safe to call from several threads at once, and
+ * must answer before it returns, a deferred response becomes a 500.
+ */
+class __HttpWebServerSocketPort__ RequestHandler
+{
+public:
+    RequestHandler() = default;
+    virtual ~RequestHandler() noexcept = 0;
+
+    /**
+     * @param connection nullptr when called on an executor thread, or by a socket without connections
+     */
+    virtual void on_request(Connection*, const HttpRequest&, ResponseWriter&) = 0;
+
+    /**
+     * @brief whether answering this request would hold up the event loop, false unless overridden
+     */
+    virtual bool is_cpu_bound(const HttpRequest&) const;
+
+    /**
+     * @brief the connection is about to be destroyed, whatever refers to it must let go
+     */
+    virtual void on_close(Connection*);
+};
+
+}}}
+
+#endif /* HTTPWEBSERVER_SOCKET_HPP_INTERFACE_REQUEST_HANDLER__ */
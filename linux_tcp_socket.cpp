@@ -18,11 +18,10 @@
 using namespace nt::http;
 
 namespace {
+#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
 const std::string
-_get_last_error()
+_get_last_error_message(const int error)
 {
-    int error = errno;
-
     switch (error) {
     case EPERM: return "Operation not permitted";
     case ENOENT: return "No such file or directory";
@@ -163,15 +162,23 @@ _get_last_error()
 const std::string
 _get_last_error(const std::string& prefix)
 {
-    return prefix + " " + _get_last_error();
+    return prefix + " " + _get_last_error_message(errno);
 }
 
-Connection*
-_create_connection(SOCKET socket)
+/**
+ * @brief what failed on the socket itself, errno belongs to whatever call came last
+ */
+const std::string
+_get_socket_error(const std::string& prefix, SOCKET socket)
 {
-    auto s = std::make_shared<RawSocket>(socket);
-    return Connection::create_socket(s);
+    int       error = 0;
+    socklen_t size  = sizeof(error);
+
+    ::getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &size);
+
+    return prefix + " " + _get_last_error_message(error);
 }
+#endif
 
 static inline int
 _get_file_type(const int fd)
@@ -189,35 +196,144 @@ _get_file_type(const int fd)
     }
 }
 
-static void
-_remove_connection(std::vector<std::shared_ptr<Connection>>& connections, const Connection* con)
+const int MAX_EVENTS = 256;
+
+const unsigned int ACCEPT_BATCH = 64;
+
+const size_t READ_SIZE = 4096;
+
+const size_t BODY_SIZE = 512;
+
+/**
+ * @brief queued output after which pipelined requests wait for the client to read
+ */
+const size_t OUTPUT_LIMIT = 64 * 1024;
+
+const unsigned int MAX_REQUESTS       = 100;
+const unsigned int KEEP_ALIVE_TIMEOUT = 5;
+const unsigned int HEADER_TIMEOUT     = 10;
+const unsigned int WRITE_TIMEOUT      = 30;
+
+/**
+ * @brief what a connection's timer is waiting for
+ */
+const unsigned int IDLE_DEADLINE   = 1;
+const unsigned int HEADER_DEADLINE = 2;
+const unsigned int BODY_DEADLINE   = 3;
+const unsigned int WRITE_DEADLINE  = 4;
+
+/**
+ * @brief not a connection's, `data` is a command to run
+ */
+const unsigned int COMMAND_DEADLINE = 5;
+
+const char CONTINUE[]    = "HTTP/1.1 100 Continue\r\n\r\n";
+const char BAD_REQUEST[] = "HTTP/1.1 400 Bad Request\r\n"
+                           "Connection: close\r\n"
+                           "Content-Length: 0\r\n\r\n";
+
+const char INTERNAL_ERROR[] = "HTTP/1.1 500 Internal Server Error\r\n"
+                              "Connection: close\r\n"
+                              "Content-Length: 0\r\n\r\n";
+
+/**
+ * @brief takes every body and drops it, used until a handler is set
+ */
+class DiscardBody :
+      public interfaces::BodyHandler
+{
+public:
+    size_t
+    on_body(Connection*, const StringView& slice)
+    {
+        return slice.size();
+    }
+
+    void
+    on_body_end(Connection*)
+    {
+    }
+};
+
+DiscardBody _discard_body;
+
+/**
+ * @brief a request handed to the executor, with its own copy of the head
+ */
+struct OffloadedRequest :
+      public Job
+{
+    Command          done;
+    LinuxTcpSocket*  socket;
+    ConnectionHandle connection;
+
+    interfaces::RequestHandler* handler;
+    bool                        keep_alive;
+
+    std::string head;
+    HttpRequest request;
+    OutputQueue output;
+};
+
+/**
+ * @brief on a worker thread, the response goes back to the loop through its mailbox
+ */
+void
+_run_offloaded(Job* job, const HeaderCache& headers)
 {
-    auto is_same_pointer = [con](std::shared_ptr<Connection> c) -> bool {
-        return &*c == con;
-    };
+    auto task = static_cast<OffloadedRequest*>(job);
+
+    ResponseWriter writer(task->output, headers, task->keep_alive, task->request.method == "HEAD");
+
+    task->handler->on_request(nullptr, task->request, writer);
+
+    // nothing on this thread could complete it later, and the loop has no connection to hand out
+    if (writer.is_deferred()) {
+        task->output.append(INTERNAL_ERROR, sizeof(INTERNAL_ERROR) - 1);
+        task->keep_alive = false;
+        task->socket->post(&task->done);
+        return;
+    }
+
+    writer.finish();
 
-    connections.erase(std::remove_if(connections.begin(),
-                                     connections.end(),
-                                     is_same_pointer
-                                    ));
+    task->keep_alive = writer.is_keep_alive();
+    task->socket->post(&task->done);
 }
 
 }
 
 LinuxTcpSocket::LinuxTcpSocket() :
-      queue_count(0),
-      max_connections(FD_SETSIZE - 1)
+      LinuxTcpSocket(PollBackend::Epoll)
 {
-    connections.reserve(max_connections);
+}
 
+LinuxTcpSocket::LinuxTcpSocket(PollBackend backend) :
+      poller(Poller::create(backend)),
+      handoff(nullptr),
+      stopping(false),
+      leave(false),
+      queue_count(0),
+      max_connections(poller->capacity()),
+      accept_batch(ACCEPT_BATCH),
+      max_requests(MAX_REQUESTS),
+      keep_alive_timeout(KEEP_ALIVE_TIMEOUT),
+      header_timeout(HEADER_TIMEOUT),
+      write_timeout(WRITE_TIMEOUT),
+      body_handler(&_discard_body),
+      request_handler(nullptr),
+      callback(nullptr),
+      executor(nullptr),
+      timers(clock.now()),
+      events(MAX_EVENTS)
+{
     auto server_socket = Connection::create_socket();
-    auto in_pipe       = Connection::create_pipe("incoming pipe");
-
-    server_socket->name = "web server";
-    in_pipe->name       = "inbound pipe";
 
     server = std::shared_ptr<Connection>(server_socket);
-    pipe   = std::shared_ptr<Connection>(in_pipe);
+
+    stop_command = {nullptr, handle_stop, this};
+
+    poller->add(mailbox.handle, Poller::READ, nullptr);
 }
 
 void
@@ -235,178 +351,793 @@ LinuxTcpSocket::bind(const char* server_address, const unsigned short port_no)
 void
 LinuxTcpSocket::listen(const unsigned int count, event_callback callback)
 {
+    set_event_callback(callback);
+
     server->socket->listen(count);
-    server->event->set();
-    pipe->event->set();
+    server->socket->set_blocking(false);
 
-    connections.push_back(server);
-    // connections.push_back(pipe);
+    poller->add(server->socket->socket, Poller::READ, server.get());
 }
 
 void
-LinuxTcpSocket::handle_new_connection()
+LinuxTcpSocket::attach(Handoff* h)
 {
-    auto client = server->socket->accept();
+    handoff = h;
 
-    auto con = Connection::create_socket(client);
-    con->name = "client";
+    poller->add(handoff->doorbell.handle, Poller::READ, nullptr);
+}
 
-    connections.push_back(std::shared_ptr<Connection>(con));
+void
+LinuxTcpSocket::post(Command* command)
+{
+    mailbox.post(command);
+}
 
-    FD_SET(client->socket, &read_list);
+void
+LinuxTcpSocket::stop()
+{
+    // the command is queued at most once, it cannot be in the queue twice
+    if (!stopping.exchange(true)) {
+        mailbox.post(&stop_command);
+    }
 }
 
 void
-LinuxTcpSocket::receive_data(SOCKET connection)
+LinuxTcpSocket::handle_stop(void* data)
 {
-    int         bytes_rx;
-    std::string request;
+    auto self = static_cast<LinuxTcpSocket*>(data);
 
-    repeat {
-        char             buffer[MAX_INPUT] = {0};
-        const static int flags             = MSG_DONTWAIT;
+    self->leave = true;
+    self->stopping.store(false);
+}
+
+unsigned int
+LinuxTcpSocket::size() const
+{
+    return queue_count.load(std::memory_order_relaxed);
+}
+
+void
+LinuxTcpSocket::set_accept_batch(const unsigned int count)
+{
+    accept_batch = count == 0 ? 1 : count;
+}
+
+void
+LinuxTcpSocket::set_max_requests(const unsigned int count)
+{
+    max_requests = count == 0 ? 1 : count;
+}
+
+void
+LinuxTcpSocket::set_keep_alive_timeout(const unsigned int seconds)
+{
+    keep_alive_timeout = seconds;
+}
+
+void
+LinuxTcpSocket::set_header_timeout(const unsigned int seconds)
+{
+    header_timeout = seconds;
+}
+
+void
+LinuxTcpSocket::set_write_timeout(const unsigned int seconds)
+{
+    write_timeout = seconds;
+}
+
+void
+LinuxTcpSocket::set_document_root(const std::string& directory)
+{
+    static_files = std::unique_ptr<StaticFiles>(new StaticFiles(directory));
+}
+
+void
+LinuxTcpSocket::set_response_cache(const size_t max_entries,
+                                   const unsigned int ttl,
+                                   const std::vector<std::string>& vary)
+{
+    response_cache = std::unique_ptr<ResponseCache>(new ResponseCache(max_entries, ttl, vary));
+}
+
+ResponseCacheStats
+LinuxTcpSocket::response_cache_stats() const
+{
+    if (response_cache == nullptr) {
+        return {0, 0, 0, 0};
+    }
+
+    return response_cache->stats();
+}
+
+void
+LinuxTcpSocket::set_request_handler(interfaces::RequestHandler* handler)
+{
+    request_handler = handler;
+}
+
+void
+LinuxTcpSocket::set_executor(Executor* pool)
+{
+    executor = pool;
+}
+
+void
+LinuxTcpSocket::set_event_callback(event_callback function)
+{
+    callback = function;
+}
+
+void
+LinuxTcpSocket::set_body_handler(interfaces::BodyHandler* handler)
+{
+    body_handler = handler == nullptr ? &_discard_body : handler;
+}
+
+void
+LinuxTcpSocket::start_deadline(Connection* connection, const unsigned int kind)
+{
+    unsigned int seconds = kind == IDLE_DEADLINE  ? keep_alive_timeout :
+                           kind == WRITE_DEADLINE ? write_timeout :
+                                                    header_timeout;
+
+    connection->timer.kind = kind;
 
-        tthread::this_thread::sleep_for(tthread::chrono::microseconds(1));
+    if (seconds == 0) {
+        timers.cancel(&connection->timer);
+    } else {
+        timers.schedule(&connection->timer, clock.now() + seconds * uint64_t(1000));
+    }
+}
+
+void
+LinuxTcpSocket::add_connection(Connection* con)
+{
+    con->interest = Poller::READ;
 
-        if ((bytes_rx = ::recv(connection, buffer, sizeof(buffer) - 1, flags)) == SOCKET_ERROR) {
-            std::string error = _get_last_error("Failed to receive data.");
+    con->input.set_pool(&buffers);
+    con->output.set_pool(&buffers);
+    con->set_parser_pool(&parsers);
 
-            // todo: do not throw, just close the socket or what not
-            // throw std::runtime_error(error.c_str());
+    connections.insert(con);
+
+    // registered once, only the interest changes afterwards
+    poller->add(con->socket->socket, Poller::READ, con);
+
+    start_deadline(con, HEADER_DEADLINE);
+
+    if (++queue_count >= max_connections && server->socket->socket != INVALID_SOCKET) {
+        poller->modify(server->socket->socket, Poller::NONE, server.get());
+    }
+}
+
+void
+LinuxTcpSocket::handle_new_connection()
+{
+    // drain the backlog, bounded so a connection storm cannot starve the clients
+    for (unsigned int i = 0; i < accept_batch && queue_count < max_connections; i++) {
+        SOCKET client = server->socket->accept();
+
+        if (client == INVALID_SOCKET) {
+#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cout << _get_last_error("Failed to accept connection.") << std::endl;
+            }
+#endif
             break;
         }
 
-        buffer[bytes_rx] = '\0';
+        add_connection(slab.create(client));
+    }
+}
 
-        request += std::string(buffer);
+void
+LinuxTcpSocket::handle_handoff()
+{
+    SOCKET client;
 
-        if (request.size() >= 4) {
-            // signifies the end of the headers
-            // if there is post data, one needs to check the
-            // Content-Length
-            std::string end    = request.substr(request.size() - 4, 4);
-            bool        is_end = end == "\r\n\r\n";
+    handoff->doorbell.drain();
 
-            if (is_end) {
-                // FD_CLR(connection, &read_list);
-                break;
-            }
+    while (handoff->queue.pop(client)) {
+        add_connection(slab.create(client));
+    }
+}
+
+void
+LinuxTcpSocket::remove_connection(Connection* connection)
+{
+    poller->remove(connection->socket->socket);
+    timers.cancel(&connection->timer);
+
+    if (connection->is_dirty) {
+        dirty.erase(std::find(dirty.begin(), dirty.end(), connection));
+    }
+
+    if (queue_count-- >= max_connections && server->socket->socket != INVALID_SOCKET) {
+        poller->modify(server->socket->socket, Poller::READ, server.get());
+    }
+
+    connections.erase(connection);
+
+    if (request_handler != nullptr) {
+        request_handler->on_close(connection);
+    }
+
+    // closes the socket, the slot goes to the next accepted connection
+    slab.destroy(connection);
+}
+
+void
+LinuxTcpSocket::set_interest(Connection* connection, const unsigned int interest)
+{
+    // the poller is only told about actual changes
+    if (connection->interest != interest) {
+        connection->interest = interest;
+
+        poller->modify(connection->socket->socket, interest, connection);
+    }
+}
+
+void
+LinuxTcpSocket::mark_dirty(Connection* connection)
+{
+    if (!connection->is_dirty) {
+        connection->is_dirty = true;
+
+        dirty.push_back(connection);
+    }
+}
+
+void
+LinuxTcpSocket::finish_request(Connection* connection)
+{
+    connection->requests++;
+
+    // the next request starts right behind this one, the answered bytes go once the batch is done
+    connection->consumed    += connection->request_size;
+    connection->request_size = 0;
+    connection->body.reset();
+
+    // the head scratch is only held while a request is under way
+    connection->release_parser();
+
+    // whatever the client was waiting on has been answered
+    timers.cancel(&connection->timer);
+
+    if (!connection->keep_alive || connection->requests >= max_requests) {
+        connection->is_closing = true;
+    }
+}
+
+void
+LinuxTcpSocket::reject(Connection* connection)
+{
+    // queued behind the responses before it, there is no telling where the next request would start
+    if (!connection->is_closing) {
+        connection->output.append(BAD_REQUEST, sizeof(BAD_REQUEST) - 1);
+    }
+
+    connection->is_closing = true;
+}
+
+bool
+LinuxTcpSocket::has_request(Connection* connection)
+{
+    const Buffer& input    = connection->input;
+    size_t        consumed = connection->consumed;
+
+    // an idle connection takes a parser once the next request starts arriving
+    if (connection->parser == nullptr && input.size() == consumed) {
+        return false;
+    }
+
+    // a head parsed before only has its views pointed at the buffer again,
+    // reading more of the body or dropping what was passed on moves it
+    switch (connection->acquire_parser().parse(input.data() + consumed, input.size() - consumed)) {
+    case HttpParser::Result::Complete:
+        break;
+    case HttpParser::Result::Error:
+        reject(connection);
+        return false;
+    default:
+        return false;
+    }
+
+    // the head is set up once, after that only the body is left to pass on
+    if (connection->request_size == 0) {
+        const HttpRequest& request = connection->parser->request();
+
+        connection->request_size = request.size;
+        connection->keep_alive   = request.keep_alive;
+
+        if (!connection->body.start(request)) {
+            reject(connection);
+            return false;
         }
-    } until(bytes_rx == 0);
 
-#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
-    std::cout << "received request from [" << connection << "]"
-              << std::endl
-              << request
-              << std::endl;
-#endif
+        const HttpHeader* expect = request.find_header("expect");
+
+        if (expect != nullptr && expect->value.equals_ignore_case("100-continue") && !connection->body.is_done()) {
+            connection->output.append(CONTINUE, sizeof(CONTINUE) - 1);
+        }
+    }
+
+    return deliver_body(connection);
+}
+
+bool
+LinuxTcpSocket::deliver_body(Connection* connection)
+{
+    Buffer& input = connection->input;
+
+    if (connection->is_paused) {
+        return false;
+    } else if (connection->body.is_done()) {
+        return !connection->is_closing;
+    }
+
+    // body bytes follow the head, they are dropped once handed over
+    size_t start = connection->consumed + connection->request_size;
+    size_t used  = 0;
+
+    while (!connection->body.is_done()) {
+        size_t     skipped;
+        StringView slice;
+
+        auto result = connection->body.next(input.data() + start + used, input.size() - start - used, skipped, slice);
+
+        used += skipped;
+
+        if (result == BodyDecoder::Result::Error) {
+            reject(connection);
+            break;
+        } else if (result != BodyDecoder::Result::Data) {
+            break;
+        }
+
+        size_t taken = body_handler->on_body(connection, slice);
+
+        connection->body.consume(taken);
+        used += taken;
+
+        if (taken < slice.size()) {
+            // reading waits for a resume, the client is not the one holding things up
+            connection->is_paused = true;
+            break;
+        }
+    }
+
+    input.erase(start, used);
+
+    if (!connection->body.is_done() || connection->is_closing) {
+        return false;
+    }
+
+    body_handler->on_body_end(connection);
+
+    return true;
 }
 
 void
-LinuxTcpSocket::write_data(SOCKET connection)
+LinuxTcpSocket::resume(const ConnectionHandle& handle)
 {
-    sockaddr_storage client_addr;
+    Connection* connection = slab.find(handle);
 
-    socklen_t storage_size = sizeof(client_addr);
+    if (connection == nullptr || !connection->is_paused) {
+        return;
+    }
 
-    ::getpeername(connection, (sockaddr*)&client_addr, &storage_size);
+    connection->is_paused = false;
+
+    process_requests(connection);
+}
+
+void
+LinuxTcpSocket::schedule(Timer* timer, Command* command, const unsigned int milliseconds)
+{
+    timer->kind = COMMAND_DEADLINE;
+    timer->data = command;
+
+    timers.schedule(timer, clock.now() + milliseconds);
+}
 
-    std::string  client_ip   = nt::http::utility::socket::get_in_ip(&client_addr);
-    unsigned int client_port = nt::http::utility::socket::get_in_port(&client_addr);
+void
+LinuxTcpSocket::cancel(Timer* timer)
+{
+    timers.cancel(timer);
+}
 
-    auto hostname = (char*)calloc(HOST_NAME_MAX + 1, sizeof(char));
-    if (::gethostname(hostname, HOST_NAME_MAX) == SOCKET_ERROR) {
-        std::string error = _get_last_error("Failed to get host name.");
+void
+LinuxTcpSocket::watch(Watch* watch)
+{
+    if (watches.size() <= static_cast<size_t>(watch->socket)) {
+        watches.resize(watch->socket + 1, nullptr);
+    }
 
-        // todo: do not throw, just close the socket or what not
-        throw std::runtime_error(error.c_str());
+    watches[watch->socket] = watch;
+    watch->ready           = Poller::NONE;
+
+    poller->add(watch->socket, watch->events, watch);
+}
+
+void
+LinuxTcpSocket::unwatch(Watch* watch)
+{
+    if (!is_watched(watch->socket, watch)) {
+        return;
     }
 
-    tthread::this_thread::sleep_for(tthread::chrono::microseconds(1));
+    watches[watch->socket] = nullptr;
 
-    std::string body = "<p>client ip: " + std::string(client_ip) + ":" + std::to_string(client_port) +
-                       "</p>\n"
-                       "<p>host name: " + std::string(hostname) +
-                       "</p>\n"
-                       "<p>"
-                       "request " + std::to_string(rand() % 100) +
-                       "</p>\n"
-                       "\r\n";
+    poller->remove(watch->socket);
+}
 
-    std::string response = "HTTP/1.1 200 OK\r\n"
-                           "Content-Type: text/html; charset=UTF-8\r\n"
-                           "Connection: keep-alive\r\n"
-                           "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" +
-                           body.c_str();
+const HeaderCache&
+LinuxTcpSocket::header_cache() const
+{
+    return headers;
+}
+
+inline bool
+LinuxTcpSocket::is_watched(const SOCKET socket, const void* data) const
+{
+    return static_cast<size_t>(socket) < watches.size() && watches[socket] == data;
+}
 
-    ::free(hostname);
-    ::send(connection, response.c_str(), response.size(), 0);
+inline bool
+LinuxTcpSocket::is_watched(const PollEvent& event) const
+{
+    return is_watched(event.socket, event.data);
+}
+
+void
+LinuxTcpSocket::handle_watch(const PollEvent& event)
+{
+    auto watch = static_cast<Watch*>(event.data);
 
+    // once only, whoever is waiting watches again if it has to
+    if (!watch->is_persistent) {
+        unwatch(watch);
+    }
+
+    watch->ready = event.events;
+    watch->command.callback(watch->command.data);
+}
+
+void
+LinuxTcpSocket::process_requests(Connection* connection)
+{
+    // answer everything that is complete, but stop queuing for a client that is not reading
+    while (!connection->is_closing &&
+           !connection->is_waiting &&
+           connection->output.size() < OUTPUT_LIMIT &&
+           has_request(connection)) {
 #ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
-    std::cout << "writing response"
-              << "to [" << connection << "]"
-              << std::endl;
+        std::cout << "received request from [" << connection->socket->socket << "]: "
+                  << connection->parser->request().method << " "
+                  << connection->parser->request().target
+                  << std::endl;
 #endif
+        write_data(connection);
+
+        // the rest waits until the executor has answered this one
+        break_if (connection->is_waiting);
+
+        finish_request(connection);
+    }
+
+    connection->is_throttled = connection->output.size() >= OUTPUT_LIMIT;
+
+    connection->input.consume(connection->consumed);
+    connection->consumed = 0;
+
+    // responses, deadlines and interest are settled once per iteration
+    mark_dirty(connection);
 }
 
 void
-LinuxTcpSocket::reset_socket_lists()
+LinuxTcpSocket::flush(Connection* connection)
 {
-    FD_ZERO(&read_list);
-    FD_ZERO(&write_list);
-    FD_ZERO(&error_list);
+    OutputQueue& output = connection->output;
+    size_t       queued = output.size();
+    ssize_t      sent   = 0;
+
+    if (queued != 0) {
+        // everything answered since the last flush goes out in one call, partial sends keep the rest queued
+        sent = output.send(connection->socket->socket);
+
+        if (sent == SOCKET_ERROR) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                remove_connection(connection);
+                return;
+            }
 
-    for (auto& connection: connections) {
-        if(connection->socket != nullptr) {
-            FD_SET(connection->socket->socket, &write_list);
-            FD_SET(connection->socket->socket, &read_list);
-            FD_SET(connection->socket->socket, &error_list);
-        } else {
-            FD_SET(connection->pipe->handle, &read_list);
-            FD_SET(connection->pipe->handle, &error_list);
+            sent = 0;
+        }
+    }
+
+    if (!output.empty()) {
+        set_interest(connection, Poller::WRITE);
+
+        // the client has this long to take each part of its responses
+        if (connection->timer.kind != WRITE_DEADLINE || sent > 0) {
+            start_deadline(connection, WRITE_DEADLINE);
         }
+        return;
+    }
+
+    // closing too must wait for the response the client is owed
+    if (connection->is_waiting) {
+        set_interest(connection, Poller::NONE);
+        timers.cancel(&connection->timer);
+        return;
     }
+
+    if (connection->is_closing) {
+        remove_connection(connection);
+        return;
+    }
+
+    if (connection->is_throttled) {
+        // requests may have been left waiting for the queue to drain
+        process_requests(connection);
+        return;
+    }
+
+    if (connection->is_paused) {
+        set_interest(connection, Poller::NONE);
+        timers.cancel(&connection->timer);
+        return;
+    }
+
+    set_interest(connection, Poller::READ);
+
+    unsigned int kind = connection->request_size != 0                          ? BODY_DEADLINE :
+                        !connection->input.empty() || connection->requests == 0 ? HEADER_DEADLINE :
+                                                                                  IDLE_DEADLINE;
+
+    // a head gets one stretch of time however it trickles in, a body as long as it keeps coming
+    if (kind != connection->timer.kind || kind == BODY_DEADLINE || !connection->timer.is_scheduled()) {
+        start_deadline(connection, kind);
+    }
+}
+
+void
+LinuxTcpSocket::flush_dirty()
+{
+    std::vector<Connection*> pending;
+
+    // a flush may queue the connection again, that waits for the next iteration
+    pending.swap(dirty);
+
+    for (auto connection : pending) {
+        connection->is_dirty = false;
+
+        flush(connection);
+    }
+}
+
+bool
+LinuxTcpSocket::receive_data(Connection* connection)
+{
+    ssize_t bytes_rx;
+    size_t  room;
+    SOCKET  socket = connection->socket->socket;
+    Buffer& input  = connection->input;
+
+    repeat {
+        // read straight into the connection's buffer, the parser works on it in place
+        char* at = input.prepare(READ_SIZE);
+
+        room     = input.room();
+        bytes_rx = ::recv(socket, at, room, MSG_DONTWAIT);
+
+        if (bytes_rx == SOCKET_ERROR) {
+            // nothing more to read for now, anything else means the socket is gone
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+
+        input.commit(bytes_rx);
+
+        // stop before the input outgrows its chunk, the rest is read once this much is handled
+    } until (bytes_rx == 0 ||
+             static_cast<size_t>(bytes_rx) < room ||
+             input.size() + READ_SIZE > buffers.chunk_size);
+
+    return bytes_rx != 0;
 }
 
-unsigned short
-LinuxTcpSocket::get_last_socket()
+void
+LinuxTcpSocket::write_data(Connection* con)
 {
-    unsigned int last_socket = server->socket->socket;
+    bool keep_alive = con->keep_alive && con->requests + 1 < max_requests;
 
-    for (auto& connection: connections) {
-        int fd = connection->socket == nullptr ?
-                 connection->pipe->handle :
-                 connection->socket->socket;
+    const HttpRequest& request = con->parser->request();
 
-        if (fd > last_socket) {
-            last_socket = fd;
+    // the built-in page names the client, only what a handler or the callback answers is shared
+    bool is_cacheable = response_cache != nullptr &&
+                        (request_handler != nullptr || callback != nullptr) &&
+                        response_cache->is_cacheable(request);
+
+    if (is_cacheable) {
+        auto cached = response_cache->find(request, keep_alive, clock.now());
+
+        if (cached != nullptr) {
+            con->output.append(*cached);
+            return;
         }
     }
 
-    return last_socket;
+    // answered when the executor posts the response back, such responses are not cached
+    if (executor != nullptr && request_handler != nullptr && request_handler->is_cpu_bound(request)) {
+        offload(con, keep_alive);
+        return;
+    }
+
+    size_t queued = con->output.size();
+
+    respond(con, keep_alive);
+
+    if (!is_cacheable || con->is_waiting) {
+        return;
+    }
+
+    std::string response;
+
+    // a handler that closed the connection did not answer what the key says
+    if ((!keep_alive || con->keep_alive) && con->output.copy_tail(con->output.size() - queued, response)) {
+        response_cache->store(std::move(response), clock.now());
+    }
 }
 
-bool
-LinuxTcpSocket::select()
+void
+LinuxTcpSocket::offload(Connection* con, const bool keep_alive)
+{
+    const HttpRequest& request = con->parser->request();
+
+    auto task = new OffloadedRequest();
+
+    task->callback   = _run_offloaded;
+    task->done       = {nullptr, handle_offloaded, task};
+    task->socket     = this;
+    task->connection = con->handle;
+    task->handler    = request_handler;
+    task->keep_alive = keep_alive;
+
+    // the receive buffer may move or go away before a worker gets to it
+    task->head.assign(con->input.data() + con->consumed, request.size);
+    task->request = request;
+
+    task->request.rebase(con->input.data() + con->consumed, task->head.data());
+
+    con->is_waiting = true;
+
+    executor->submit(task);
+}
+
+void
+LinuxTcpSocket::handle_offloaded(void* data)
 {
-    reset_socket_lists();
+    std::unique_ptr<OffloadedRequest> task(static_cast<OffloadedRequest*>(data));
+
+    task->socket->complete(task->connection, task->output, task->keep_alive);
+}
 
-    unsigned short last_socket = get_last_socket();
-    Timeval timeout = Timeval::Infinite;
+void
+LinuxTcpSocket::complete(const ConnectionHandle& handle, OutputQueue& response, const bool keep_alive)
+{
+    Connection* connection = slab.find(handle);
+
+    if (connection == nullptr || !connection->is_waiting) {
+        return;
+    }
 
-    int select_result;
+    connection->output.append(response);
+    connection->is_waiting = false;
 
+    if (!keep_alive) {
+        connection->keep_alive = false;
+    }
+
+    finish_request(connection);
+    process_requests(connection);
+}
+
+void
+LinuxTcpSocket::respond(Connection* con, const bool keep_alive)
+{
+    SOCKET connection = con->socket->socket;
+
+    const HttpRequest& request = con->parser->request();
+
+    if (request_handler != nullptr || callback != nullptr) {
+        ResponseWriter writer(con->output, headers, keep_alive, request.method == "HEAD");
+
+        if (request_handler != nullptr) {
+            request_handler->on_request(con, request, writer);
+        } else {
+            callback(const_cast<HttpRequest*>(&request), &writer);
+        }
+
+        // answered through complete(), the requests behind it wait until then
+        if (writer.is_deferred()) {
+            con->is_waiting = true;
+            return;
+        }
+
+        writer.finish();
+
+        if (!writer.is_keep_alive()) {
+            con->keep_alive = false;
+        }
+
+        return;
+    }
+
+    if (static_files != nullptr) {
+        ResponseBuilder response(con->output);
+
+        static_files->serve(request, response, headers, keep_alive, clock.now());
+        return;
+    }
+
+    // only this fallback page names the client, connections do not keep its address
+    sockaddr_storage client_addr;
+
+    socklen_t storage_size = sizeof(client_addr);
+
+    ::getpeername(connection, (sockaddr*)&client_addr, &storage_size);
+
+    std::string peer = nt::http::utility::socket::get_in_ip(&client_addr) + ":" +
+                       std::to_string(nt::http::utility::socket::get_in_port(&client_addr));
+
+    StringView hostname = headers.hostname();
+
+    char body[BODY_SIZE];
+    int  body_size = std::snprintf(body, sizeof(body),
+                                   "<p>client ip: %s</p>\n"
+                                   "<p>host name: %.*s</p>\n"
+                                   "<p>request %d</p>\n"
+                                   "\r\n",
+                                   peer.c_str(),
+                                   static_cast<int>(hostname.size()), hostname.data(),
+                                   rand() % 100);
+
+    // sent with the rest of the batch, in the order the requests came in
+    ResponseBuilder response(con->output);
+
+    response.status(200);
+    response.append(headers.server_headers());
+    response.header("Content-Type", "text/html; charset=UTF-8");
+    response.header("Connection", keep_alive ? "keep-alive" : "close");
+    response.header("Content-Length", static_cast<size_t>(body_size));
+    response.end_headers();
+    response.body(StringView(body, body_size));
+
+#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
+    std::cout << "queued response "
+              << "to [" << connection << "]"
+              << std::endl;
+#endif
+}
+
+int
+LinuxTcpSocket::poll()
+{
 #ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
-    std::cout << "selecting from " << connections.size() << " connection(s)\n";
+    std::cout << "polling " << connections.size() << " connection(s)\n";
 #endif
 
-    if ((select_result = ::select(last_socket + 1, &read_list, &write_list, &error_list, timeout)) == SOCKET_ERROR) {
-        std::string error = _get_last_error("Failed to poll connections.");
+    // connections left with work from the last iteration must not wait for new events
+    long timeout = dirty.empty() ? timers.next_timeout() : 0;
 
-        throw std::runtime_error(error.c_str());
-    }
+    int ready = poller->wait(events.data(), events.size(), Timeval::from_milliseconds(timeout));
+
+    clock.update();
+    headers.update(clock.now());
 
-    return select_result == 0;
+    return ready;
 }
 
 inline bool
@@ -417,77 +1148,70 @@ LinuxTcpSocket::is_new_connection(const Connection* connection) {
 void
 LinuxTcpSocket::open()
 {
-    unsigned int ceiling = 0;
+    leave = false;
 
     while (true) {
-        bool leave = false;
-
-        continue_if (select());
-
-        for (auto& connection : connections) {
-            if (connection->pipe != nullptr) {
-                std::cout << "pipe ";
-
-                if (FD_ISSET(connection->pipe->handle, &read_list)) {
-                    std::cout << "read\n";
-                    char buff[100] = {0};
-
-                    ::read(connection->pipe->handle, (void*)buff, 99);
-                    std::cout << "read :" << buff << std::endl;
-
-                    //// writing will generate another read event
-                    //// use pipe socket for writing
-                    // char reply[100] = "reply\n";
-                    // write(connection->socket, reply, 100);
-
-                    FD_CLR(connection->pipe->handle, &read_list);
-                }
-
-                // if (FD_ISSET(connection->pipe->handle, &write_list) && connection->is_read) {
-                //     std::cout << "write\n";
-                //     FD_CLR(connection->pipe->handle, &write_list);
-                // }
-
-                if (FD_ISSET(connection->pipe->handle, &error_list)) {
-                    std::cout << "error\n";
-                    FD_CLR(connection->pipe->handle, &error_list);
-                }
-            } else if (connection->socket != nullptr) {
-                if (FD_ISSET(connection->socket->socket, &read_list)) {
-                    if (is_new_connection(connection.get())) {
-                        if (ceiling < max_connections) {
-                            handle_new_connection();
-                            ceiling++;
-                        }
-
-                        break;
-                    } else {
-                        receive_data(connection->socket->socket);
-                        connection->is_read = true;
-
-                        FD_CLR(connection->socket->socket, &read_list);
-                    }
-                }
-
-                if (FD_ISSET(connection->socket->socket, &write_list) && connection->is_read) {
-                    write_data(connection->socket->socket);
-                    ceiling--;
-
-                    FD_CLR(connection->socket->socket, &write_list);
-                    _remove_connection(connections, connection.get());
-                }
-
-                if (FD_ISSET(connection->socket->socket, &error_list)) {
-                    std::cout << _get_last_error("Socket exception.") << std::endl;
-
-                    ceiling--;
-
-                    FD_CLR(connection->socket->socket, &error_list);
-                    _remove_connection(connections, connection.get());
-                }
+        int ready = poll();
+
+        for (int i = 0; i < ready; i++) {
+            auto& event      = events[i];
+            auto  connection = static_cast<Connection*>(event.data);
+
+            if (event.socket == mailbox.handle) {
+                mailbox.run();
+                continue;
+            }
+
+            if (handoff != nullptr && event.socket == handoff->doorbell.handle) {
+                handle_handoff();
+                continue;
+            }
+
+            continue_if (connection == nullptr);
+
+            if (is_watched(event)) {
+                handle_watch(event);
+                continue;
+            }
+
+            // the event of a watch dropped earlier in this batch is not a connection's
+            continue_if (!watches.empty() && connection != server.get() && connections.find(event.socket) != connection);
+
+            if (is_new_connection(connection)) {
+                handle_new_connection();
+            } else if (event.events & Poller::ERROR) {
+#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
+                std::cout << _get_socket_error("Socket exception.", connection->socket->socket) << std::endl;
+#endif
+
+                remove_connection(connection);
+            } else if (event.events & Poller::READ) {
+                bool is_open = receive_data(connection);
+
+                // requests the client sent before it hung up still get their answers
+                process_requests(connection);
+
+                connection->is_closing |= !is_open;
+            } else if (event.events & Poller::WRITE) {
+                mark_dirty(connection);
             }
         }
 
+        flush_dirty();
+
+        timers.advance(clock.now(), [this](Timer* timer) {
+#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
+            std::cout << "deadline " << timer->kind << " expired" << std::endl;
+#endif
+            if (timer->kind == COMMAND_DEADLINE) {
+                auto command = static_cast<Command*>(timer->data);
+
+                command->callback(command->data);
+            } else {
+                remove_connection(static_cast<Connection*>(timer->data));
+            }
+        });
+
         break_if(leave);
     }
 }
@@ -495,7 +1219,16 @@ LinuxTcpSocket::open()
 void
 LinuxTcpSocket::close()
 {
-    connections.clear();
-    pipe->pipe->close();
+    // erasing moves the last connection into the gap, the walk goes over a copy
+    std::vector<Connection*> remaining(connections.begin(), connections.end());
+
+    for (auto connection : remaining) {
+        remove_connection(connection);
+    }
+
+    // commands posted after the loop stopped still own what they carry, e.g. offloaded responses;
+    // the connections they name are gone, so running them only frees it
+    mailbox.run();
+
     server->socket->close();
 }
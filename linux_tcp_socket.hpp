@@ -3,55 +3,282 @@
 
 #include <string>
 #include <vector>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 
 #include "common.hpp"
 #include "raw_socket.hpp"
-#include "pipe.hpp"
 #include "connection.hpp"
 #include "interfaces/socket.hpp"
+#include "interfaces/body_handler.hpp"
+#include "interfaces/request_handler.hpp"
 #include "connection.hpp"
 #include "timeval.hpp"
+#include "loop_clock.hpp"
+#include "timer_wheel.hpp"
+#include "poller.hpp"
+#include "handoff.hpp"
+#include "mailbox.hpp"
+#include "buffer_pool.hpp"
+#include "parser_pool.hpp"
+#include "connection_slab.hpp"
+#include "connection_table.hpp"
+#include "header_cache.hpp"
+#include "response_builder.hpp"
+#include "response_writer.hpp"
+#include "static_files.hpp"
+#include "response_cache.hpp"
+#include "executor.hpp"
 
 namespace nt { namespace http {
 
 typedef void (* event_callback)(void*, void*);
 
+/**
+ * @brief a descriptor watched by the loop on someone else's behalf
+ *
+ * `command` runs on the loop thread the first time any of `events` is
+ * ready, `ready` then holds what was. The watch is dropped before that
+ * unless it is persistent, then the command runs on every iteration the
+ * descriptor is ready until it is unwatched. The owner keeps it alive
+ * while it is watched.
+ */
+struct Watch
+{
+    SOCKET       socket;
+    unsigned int events;
+    unsigned int ready;
+    bool         is_persistent;
+    Command      command;
+};
+
 class __HttpWebServerSocketPort__ LinuxTcpSocket :
       public nt::http::interfaces::Socket
 {
 private:
     std::shared_ptr<Connection> server;
-    std::shared_ptr<Connection> pipe;
 private:
-    unsigned int       queue_count;
-    const unsigned int max_connections;
+    std::unique_ptr<Poller> poller;
+    Handoff*                handoff;
+
+    Mailbox           mailbox;
+    Command           stop_command;
+    std::atomic<bool> stopping;
+    bool              leave;
+
+    std::atomic<unsigned int> queue_count;
+    const unsigned int        max_connections;
+    unsigned int              accept_batch;
+
+    unsigned int max_requests;
+    unsigned int keep_alive_timeout;
+    unsigned int header_timeout;
+    unsigned int write_timeout;
+
+    interfaces::BodyHandler*    body_handler;
+    interfaces::RequestHandler* request_handler;
+    event_callback              callback;
+    Executor*                   executor;
+
+    std::unique_ptr<StaticFiles>   static_files;
+    std::unique_ptr<ResponseCache> response_cache;
+
+    LoopClock   clock;
+    TimerWheel  timers;
+    HeaderCache headers;
 
-    std::vector<std::shared_ptr<Connection>> connections;
+    /**
+     * @brief connection buffers and parsers, declared first so they outlive the connections
+     */
+    BufferPool     buffers;
+    ParserPool     parsers;
+    ConnectionSlab slab;
 
-    fd_set read_list;
-    fd_set write_list;
-    fd_set error_list;
+    ConnectionTable        connections;
+    std::vector<PollEvent> events;
+
+    /**
+     * @brief watches by descriptor
+     */
+    std::vector<Watch*> watches;
+
+    /**
+     * @brief connections with responses to send or state to settle at the end of the iteration
+     */
+    std::vector<Connection*> dirty;
 
 public:
     LinuxTcpSocket();
+    explicit LinuxTcpSocket(PollBackend);
     ~LinuxTcpSocket() noexcept = default;
 
     void bind(const char*, const char*);
     void bind(const char*, const unsigned short);
+
+    /**
+     * @param callback called with a `const HttpRequest*` and a `ResponseWriter*` for
+     *        every request when no request handler is set, may be nullptr
+     */
     void listen(const unsigned int, event_callback);
     void open();
+
+    /**
+     * @brief close every connection and the listening socket, once `open()` has returned
+     *        and the executor, if any, has finished
+     */
     void close();
 
+    /**
+     * @brief run a command on the loop thread, safe to call from any thread
+     */
+    void post(Command*);
+
+    /**
+     * @brief make `open()` return after the current iteration, safe to call from any thread
+     */
+    void stop();
+
+    /**
+     * @brief serve sockets accepted elsewhere instead of (or as well as) listening
+     */
+    void attach(Handoff*);
+
+    /**
+     * @brief number of open client connections, safe to read from other threads
+     */
+    unsigned int size() const;
+
+    /**
+     * @brief most connections accepted per wakeup before other sockets are served
+     */
+    void set_accept_batch(const unsigned int);
+
+    /**
+     * @brief requests served on one persistent connection before it is closed
+     */
+    void set_max_requests(const unsigned int);
+
+    /**
+     * @brief seconds a persistent connection may wait for its next request, 0 disables
+     */
+    void set_keep_alive_timeout(const unsigned int);
+
+    /**
+     * @brief seconds a client has to send a complete request head, and the
+     *        longest it may stall while sending a body, 0 disables
+     */
+    void set_header_timeout(const unsigned int);
+
+    /**
+     * @brief seconds a response may wait for the client to accept it, 0 disables
+     */
+    void set_write_timeout(const unsigned int);
+
+    /**
+     * @brief answer every request with the files under `directory`
+     */
+    void set_document_root(const std::string&);
+
+    /**
+     * @brief answer repeated GET and HEAD requests from the responses queued for the first one
+     *
+     * Only responses of the request handler or the listen callback are kept,
+     * static files and the built-in page are always answered afresh.
+     * @param max_entries responses kept at most
+     * @param ttl milliseconds a response is reused
+     * @param vary request headers that select between responses
+     */
+    void set_response_cache(const size_t, const unsigned int, const std::vector<std::string>& = {});
+
+    /**
+     * @brief cache counters of this loop, safe to read from other threads
+     */
+    ResponseCacheStats response_cache_stats() const;
+
+    /**
+     * @brief who answers requests, ahead of the listen callback and the document root
+     */
+    void set_request_handler(interfaces::RequestHandler*);
+
+    /**
+     * @brief run CPU bound requests of the request handler on these workers instead of the loop
+     *
+     * One executor may serve several sockets. Destroy it once their loops have
+     * stopped and before the sockets themselves, answers still in flight are dropped.
+     */
+    void set_executor(Executor*);
+
+    /**
+     * @brief the callback `listen()` takes, for loops fed by another socket's acceptor
+     */
+    void set_event_callback(event_callback);
+
+    /**
+     * @brief where request bodies go, they are discarded without one
+     */
+    void set_body_handler(interfaces::BodyHandler*);
+
+    /**
+     * @brief read again from a connection whose body handler was full, on the loop thread
+     *
+     * Does nothing if the connection has been closed in the meantime.
+     */
+    void resume(const ConnectionHandle&);
+
+    /**
+     * @brief the deferred response of a connection, on the loop thread
+     *
+     * Everything queued in `response` is moved to the connection and the
+     * requests behind it are processed. Does nothing if the connection has
+     * been closed in the meantime.
+     */
+    void complete(const ConnectionHandle&, OutputQueue&, const bool);
+
+    /**
+     * @brief run a command on the loop thread after the given milliseconds
+     */
+    void schedule(Timer*, Command*, const unsigned int);
+    void cancel(Timer*);
+
+    /**
+     * @brief watch a descriptor for readiness once, on the loop thread
+     */
+    void watch(Watch*);
+    void unwatch(Watch*);
+
+    /**
+     * @brief `Server` and `Date` lines of this loop, for responses written outside a request handler call
+     */
+    const HeaderCache& header_cache() const;
+
 private:
-    void reset_socket_lists();
-    unsigned short get_last_socket();
-    bool select();
+    static void handle_stop(void*);
+    static void handle_offloaded(void*);
+
+    int poll();
     inline bool is_new_connection(const Connection*);
+    inline bool is_watched(const SOCKET, const void*) const;
+    inline bool is_watched(const PollEvent&) const;
+    void handle_watch(const PollEvent&);
     void handle_new_connection();
-    void receive_data(SOCKET);
-    void write_data(SOCKET);
+    void handle_handoff();
+    void add_connection(Connection*);
+    void remove_connection(Connection*);
+    void set_interest(Connection*, const unsigned int);
+    void mark_dirty(Connection*);
+    void finish_request(Connection*);
+    void start_deadline(Connection*, const unsigned int);
+    bool has_request(Connection*);
+    bool deliver_body(Connection*);
+    void reject(Connection*);
+    void process_requests(Connection*);
+    void flush(Connection*);
+    void flush_dirty();
+    bool receive_data(Connection*);
+    void write_data(Connection*);
+    void respond(Connection*, const bool);
+    void offload(Connection*, const bool);
 };
 
 }}
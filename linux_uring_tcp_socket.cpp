@@ -0,0 +1,563 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <cstring>
+#include <cstdio>
+
+#include <poll.h>
+
+#include <macros/leave_loop_if.hpp>
+
+#include <utility/socket.hpp>
+
+#include "linux_uring_tcp_socket.hpp"
+#include "response_builder.hpp"
+#include "response_writer.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const uint64_t ACCEPT   = 1;
+const uint64_t RECV     = 2;
+const uint64_t SEND     = 3;
+const uint64_t WRITABLE = 4;
+const uint64_t STOP     = 5;
+const uint64_t CANCEL   = 6;
+
+const unsigned int MAX_REQUESTS = 100;
+
+const size_t BODY_SIZE = 512;
+
+/**
+ * @brief queued output after which pipelined requests wait for the client to read
+ */
+const size_t OUTPUT_LIMIT = 64 * 1024;
+
+const char CONTINUE[]    = "HTTP/1.1 100 Continue\r\n\r\n";
+const char BAD_REQUEST[] = "HTTP/1.1 400 Bad Request\r\n"
+                           "Connection: close\r\n"
+                           "Content-Length: 0\r\n\r\n";
+
+const char INTERNAL_ERROR[] = "HTTP/1.1 500 Internal Server Error\r\n"
+                              "Connection: close\r\n"
+                              "Content-Length: 0\r\n\r\n";
+
+inline uint64_t
+_user_data(const uint64_t operation, SOCKET socket)
+{
+    return (operation << 32) | static_cast<uint32_t>(socket);
+}
+
+inline uint64_t
+_operation(const uint64_t user_data)
+{
+    return user_data >> 32;
+}
+
+inline SOCKET
+_socket(const uint64_t user_data)
+{
+    return static_cast<SOCKET>(user_data & 0xffffffff);
+}
+
+}
+
+LinuxUringTcpSocket::LinuxUringTcpSocket() :
+      LinuxUringTcpSocket(256, 1024, 4096)
+{
+}
+
+LinuxUringTcpSocket::LinuxUringTcpSocket(const unsigned int depth, const unsigned int count, const unsigned int size) :
+      ring(nullptr),
+      queue_depth(depth),
+      buffer_count(count),
+      buffer_size(size),
+      peer_count(0),
+      leave(false),
+      accepting(false),
+      max_requests(MAX_REQUESTS),
+      request_handler(nullptr),
+      callback(nullptr)
+{
+    auto server_socket = Connection::create_socket();
+
+    server = std::shared_ptr<Connection>(server_socket);
+}
+
+void
+LinuxUringTcpSocket::bind(const char* server_address, const char* service)
+{
+    server->socket->bind(server_address, service);
+}
+
+void
+LinuxUringTcpSocket::bind(const char* server_address, const unsigned short port_no)
+{
+    server->socket->bind(server_address, port_no);
+}
+
+void
+LinuxUringTcpSocket::listen(const unsigned int count, event_callback callback)
+{
+    this->callback = callback;
+
+    server->socket->listen(count);
+
+    ring = std::unique_ptr<Uring>(new Uring(queue_depth));
+    ring->register_buffers(0, buffer_count, buffer_size);
+}
+
+void
+LinuxUringTcpSocket::set_max_requests(const unsigned int count)
+{
+    max_requests = count == 0 ? 1 : count;
+}
+
+void
+LinuxUringTcpSocket::set_request_handler(interfaces::RequestHandler* handler)
+{
+    request_handler = handler;
+}
+
+void
+LinuxUringTcpSocket::stop()
+{
+    leave.store(true);
+    doorbell.ring();
+}
+
+void
+LinuxUringTcpSocket::handle_accept(const io_uring_cqe& cqe)
+{
+    if (cqe.res >= 0 && leave.load()) {
+        // accepted while stopping, it never gets a peer
+        ::close(cqe.res);
+    } else if (cqe.res >= 0) {
+        SOCKET client = cqe.res;
+
+        if (peers.size() <= static_cast<size_t>(client)) {
+            peers.resize(client + 1);
+        }
+
+        peers[client] = std::unique_ptr<Peer>(new Peer());
+        peer_count++;
+
+        Peer* peer = peers[client].get();
+
+        peer->input.set_pool(&buffers);
+        peer->output.set_pool(&buffers);
+        peer->receiving = true;
+
+        ring->prepare_multishot_recv(client, _user_data(RECV, client));
+    }
+#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
+    else {
+        std::cout << "accept failed: " << std::strerror(-cqe.res) << std::endl;
+    }
+#endif
+
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        accepting = !leave.load();
+
+        if (accepting) {
+            ring->prepare_multishot_accept(server->socket->socket, _user_data(ACCEPT, server->socket->socket));
+        }
+    }
+}
+
+void
+LinuxUringTcpSocket::handle_receive(SOCKET client, const io_uring_cqe& cqe)
+{
+    Peer* peer = static_cast<size_t>(client) < peers.size() ? peers[client].get() : nullptr;
+
+    if (peer == nullptr) {
+        return;
+    }
+
+    if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+        auto id = static_cast<unsigned short>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+
+        // nothing more is answered on a closing connection
+        if (!peer->is_closing) {
+            peer->input.append(ring->get_buffer(id), cqe.res);
+        }
+
+        ring->recycle_buffer(id);
+    } else if (cqe.res == 0) {
+        peer->is_eof = true;
+    } else if (cqe.res != -ENOBUFS) {
+        // the socket failed, whatever is queued cannot be delivered either
+        peer->is_eof     = true;
+        peer->is_closing = true;
+    }
+
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        peer->receiving = !peer->is_eof && !peer->is_closing;
+
+        if (peer->receiving) {
+            // out of buffers or the kernel stopped the multishot request, arm it again
+            ring->prepare_multishot_recv(client, _user_data(RECV, client));
+        }
+    }
+
+    // a send in flight reads the output queue, the rest waits for its completion
+    if (!peer->sending) {
+        process_requests(client, peer);
+    }
+}
+
+bool
+LinuxUringTcpSocket::has_request(Peer* peer)
+{
+    Buffer& input = peer->input;
+
+    // a head parsed before only has its views pointed at the buffer again, receiving may have moved it
+    switch (peer->parser.parse(input.data(), input.size())) {
+    case HttpParser::Result::Complete:
+        break;
+    case HttpParser::Result::Error:
+        reject(peer);
+        return false;
+    default:
+        return false;
+    }
+
+    if (peer->request_size == 0) {
+        const HttpRequest& request = peer->parser.request();
+
+        peer->request_size = request.size;
+        peer->keep_alive   = request.keep_alive;
+
+        if (!peer->body.start(request)) {
+            reject(peer);
+            return false;
+        }
+
+        const HttpHeader* expect = request.find_header("expect");
+
+        if (expect != nullptr && expect->value.equals_ignore_case("100-continue") && !peer->body.is_done()) {
+            peer->output.append(CONTINUE, sizeof(CONTINUE) - 1);
+        }
+    }
+
+    // the body is read and dropped, only its framing is looked at; the head before it stays put
+    size_t used = 0;
+
+    while (!peer->body.is_done()) {
+        size_t     skipped;
+        StringView slice;
+
+        auto result = peer->body.next(input.data() + peer->request_size + used,
+                                      input.size() - peer->request_size - used,
+                                      skipped,
+                                      slice);
+
+        used += skipped;
+
+        if (result == BodyDecoder::Result::Error) {
+            reject(peer);
+            break;
+        } else if (result != BodyDecoder::Result::Data) {
+            break;
+        }
+
+        peer->body.consume(slice.size());
+        used += slice.size();
+    }
+
+    input.erase(peer->request_size, used);
+
+    return peer->body.is_done() && !peer->is_closing;
+}
+
+void
+LinuxUringTcpSocket::reject(Peer* peer)
+{
+    // queued behind the responses before it, there is no telling where the next request would start
+    if (!peer->is_closing) {
+        peer->output.append(BAD_REQUEST, sizeof(BAD_REQUEST) - 1);
+    }
+
+    peer->is_closing = true;
+}
+
+void
+LinuxUringTcpSocket::process_requests(SOCKET client, Peer* peer)
+{
+    // answer everything that is complete, but stop queuing for a client that is not reading
+    while (!peer->is_closing && peer->output.size() < OUTPUT_LIMIT && has_request(peer)) {
+#ifdef HTTP_WEB_SERVER_SOCKET_DEBUG
+        std::cout << "received request from [" << client << "]: "
+                  << peer->parser.request().method << " "
+                  << peer->parser.request().target
+                  << std::endl;
+#endif
+        respond(client, peer);
+
+        peer->requests++;
+        peer->input.consume(peer->request_size);
+        peer->request_size = 0;
+        peer->parser.reset();
+        peer->body.reset();
+
+        if (!peer->keep_alive || peer->requests >= max_requests) {
+            peer->is_closing = true;
+        }
+    }
+
+    // whatever is left after the client's last byte can never complete
+    if (peer->is_eof && peer->output.size() < OUTPUT_LIMIT) {
+        peer->is_closing = true;
+    }
+
+    flush(client, peer);
+}
+
+void
+LinuxUringTcpSocket::respond(SOCKET client, Peer* peer)
+{
+    bool keep_alive = peer->keep_alive && peer->requests + 1 < max_requests;
+
+    if (request_handler != nullptr || callback != nullptr) {
+        const HttpRequest& request = peer->parser.request();
+
+        ResponseWriter writer(peer->output, headers, keep_alive, request.method == "HEAD");
+
+        if (request_handler != nullptr) {
+            request_handler->on_request(nullptr, request, writer);
+        } else {
+            callback(const_cast<HttpRequest*>(&request), &writer);
+        }
+
+        // there is no connection the response could be completed on later
+        if (writer.is_deferred()) {
+            peer->output.append(INTERNAL_ERROR, sizeof(INTERNAL_ERROR) - 1);
+            peer->keep_alive = false;
+            return;
+        }
+
+        writer.finish();
+
+        if (!writer.is_keep_alive()) {
+            peer->keep_alive = false;
+        }
+
+        return;
+    }
+
+    // the peer does not change, it is looked up once per connection
+    if (peer->address.empty()) {
+        sockaddr_storage client_addr;
+
+        socklen_t storage_size = sizeof(client_addr);
+
+        ::getpeername(client, (sockaddr*)&client_addr, &storage_size);
+
+        peer->address = nt::http::utility::socket::get_in_ip(&client_addr) + ":" +
+                        std::to_string(nt::http::utility::socket::get_in_port(&client_addr));
+    }
+
+    StringView hostname = headers.hostname();
+
+    char body[BODY_SIZE];
+    int  body_size = std::snprintf(body, sizeof(body),
+                                   "<p>client ip: %s</p>\n"
+                                   "<p>host name: %.*s</p>\n"
+                                   "<p>request %d</p>\n"
+                                   "\r\n",
+                                   peer->address.c_str(),
+                                   static_cast<int>(hostname.size()), hostname.data(),
+                                   rand() % 100);
+
+    ResponseBuilder response(peer->output);
+
+    response.status(200);
+    response.append(headers.server_headers());
+    response.header("Content-Type", "text/html; charset=UTF-8");
+    response.header("Connection", keep_alive ? "keep-alive" : "close");
+    response.header("Content-Length", static_cast<size_t>(body_size));
+    response.end_headers();
+    response.body(StringView(body, body_size));
+}
+
+void
+LinuxUringTcpSocket::flush(SOCKET client, Peer* peer)
+{
+    if (peer->sending) {
+        return;
+    }
+
+    if (!peer->output.empty()) {
+        size_t count;
+
+        peer->output.gather(peer->vectors, MAX_VECTORS, count);
+
+        if (count > 0) {
+            peer->message.msg_iov    = peer->vectors;
+            peer->message.msg_iovlen = count;
+            peer->sending            = true;
+
+            // goes out with the next submit, together with everything else queued this round
+            ring->prepare_sendmsg(client, &peer->message, _user_data(SEND, client));
+            return;
+        }
+
+        // a file comes first, it goes out with sendfile and waits for room if the socket is full
+        ssize_t sent = peer->output.send(client);
+
+        if (sent == SOCKET_ERROR && errno != EAGAIN && errno != EWOULDBLOCK) {
+            peer->output.clear();
+            peer->is_closing = true;
+        } else if (!peer->output.empty() || (!peer->is_closing && !peer->input.empty())) {
+            // requests held back behind the file are answered once the wait completes
+            peer->sending = true;
+
+            ring->prepare_poll(client, POLLOUT, _user_data(WRITABLE, client));
+            return;
+        }
+    }
+
+    if (!peer->is_closing) {
+        return;
+    }
+
+    if (peer->receiving) {
+        // completes the pending multishot receive, the socket is released from there
+        ::shutdown(client, SHUT_RDWR);
+    } else {
+        release(client, peer);
+    }
+}
+
+void
+LinuxUringTcpSocket::handle_send(SOCKET client, const io_uring_cqe& cqe)
+{
+    Peer* peer = static_cast<size_t>(client) < peers.size() ? peers[client].get() : nullptr;
+
+    if (peer == nullptr) {
+        return;
+    }
+
+    peer->sending = false;
+
+    if (cqe.res < 0) {
+        peer->output.clear();
+        peer->is_closing = true;
+    } else {
+        peer->output.consume(cqe.res);
+    }
+
+    // requests received while the send was in flight are answered now
+    process_requests(client, peer);
+}
+
+void
+LinuxUringTcpSocket::handle_writable(SOCKET client, const io_uring_cqe&)
+{
+    Peer* peer = static_cast<size_t>(client) < peers.size() ? peers[client].get() : nullptr;
+
+    if (peer == nullptr) {
+        return;
+    }
+
+    // an error or hang up shows when sending again
+    peer->sending = false;
+
+    process_requests(client, peer);
+}
+
+void
+LinuxUringTcpSocket::drain()
+{
+    if (accepting) {
+        ring->prepare_cancel(_user_data(ACCEPT, server->socket->socket), _user_data(CANCEL, server->socket->socket));
+    }
+
+    for (size_t i = 0; i < peers.size(); i++) {
+        Peer* peer = peers[i].get();
+
+        continue_if (peer == nullptr);
+
+        peer->is_eof     = true;
+        peer->is_closing = true;
+
+        // whatever is in flight fails or ends, the peer is released with the last of it
+        if (peer->receiving || peer->sending) {
+            ::shutdown(static_cast<SOCKET>(i), SHUT_RDWR);
+        } else {
+            release(static_cast<SOCKET>(i), peer);
+        }
+    }
+}
+
+void
+LinuxUringTcpSocket::release(SOCKET client, Peer*)
+{
+    ::close(client);
+
+    peers[client].reset();
+    peer_count--;
+}
+
+void
+LinuxUringTcpSocket::open()
+{
+    SOCKET listener    = server->socket->socket;
+    bool   watching    = true;
+    bool   is_draining = false;
+
+    accepting = true;
+
+    ring->prepare_multishot_accept(listener, _user_data(ACCEPT, listener));
+    ring->prepare_poll(doorbell.handle, POLLIN, _user_data(STOP, doorbell.handle));
+
+    // after a stop the loop goes on until nothing armed is left in the kernel
+    while (accepting || watching || peer_count > 0) {
+        ring->submit(1);
+
+        clock.update();
+        headers.update(clock.now());
+
+        ring->for_each_completion([this, &watching](const io_uring_cqe& cqe) {
+            SOCKET socket = _socket(cqe.user_data);
+
+            switch (_operation(cqe.user_data)) {
+            case ACCEPT:
+                handle_accept(cqe);
+                break;
+            case RECV:
+                handle_receive(socket, cqe);
+                break;
+            case SEND:
+                handle_send(socket, cqe);
+                break;
+            case WRITABLE:
+                handle_writable(socket, cqe);
+                break;
+            case STOP:
+                watching = false;
+                break;
+            default:
+                break;
+            }
+        });
+
+        if (leave.load() && !is_draining) {
+            is_draining = true;
+            drain();
+        }
+    }
+
+    // ready for another run
+    doorbell.drain();
+    leave.store(false);
+}
+
+void
+LinuxUringTcpSocket::close()
+{
+    ring.reset();
+
+    server->socket->close();
+}
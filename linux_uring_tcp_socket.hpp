@@ -0,0 +1,172 @@
+#ifndef HTTPWEBSERVER_LINUX_URING_TCP_SOCKET_HPP__
+#define HTTPWEBSERVER_LINUX_URING_TCP_SOCKET_HPP__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include "common.hpp"
+#include "raw_socket.hpp"
+#include "connection.hpp"
+#include "doorbell.hpp"
+#include "http_parser.hpp"
+#include "body_decoder.hpp"
+#include "buffer.hpp"
+#include "buffer_pool.hpp"
+#include "output_queue.hpp"
+#include "loop_clock.hpp"
+#include "header_cache.hpp"
+#include "interfaces/socket.hpp"
+#include "interfaces/request_handler.hpp"
+
+// after the headers above, the kernel's headers define BLOCK_SIZE
+#include "uring.hpp"
+
+namespace nt { namespace http {
+
+typedef void (* event_callback)(void*, void*);
+
+/**
+ * @brief completion based event loop
+ *
+ * Accepts and receives are armed once as multishot requests reading into
+ * a kernel managed buffer ring. Requests are parsed and answered in order
+ * on persistent connections, the responses of one round go out as
+ * gathered sends submitted together with the next wait. There are no
+ * idle or header deadlines, and request bodies are read and dropped.
+ *
+ * Requests go to the request handler, else the listen callback, else get
+ * the built-in status page. Handlers are called without a connection and
+ * must answer before they return, a deferred response becomes a 500.
+ */
+class __HttpWebServerSocketPort__ LinuxUringTcpSocket :
+      public nt::http::interfaces::Socket
+{
+private:
+    static const size_t MAX_VECTORS = 16;
+
+    struct Peer
+    {
+        Buffer      input;
+        HttpParser  parser;
+        BodyDecoder body;
+        OutputQueue output;
+
+        /**
+         * @brief the send in flight, the kernel reads it until it completes
+         */
+        msghdr message;
+        iovec  vectors[MAX_VECTORS];
+
+        /**
+         * @brief head of the current request, 0 until it is complete
+         */
+        size_t       request_size;
+        unsigned int requests;
+        bool         keep_alive;
+
+        /**
+         * @brief `ip:port` of the client, looked up with its first response
+         */
+        std::string address;
+
+        bool receiving;
+
+        /**
+         * @brief a send or a wait for room to send is in flight, nothing is added to `output` meanwhile
+         */
+        bool sending;
+
+        /**
+         * @brief no more requests are answered, the socket goes once `output` is sent
+         */
+        bool is_closing;
+
+        /**
+         * @brief the client sent all it will, requests already received are still answered
+         */
+        bool is_eof;
+    };
+
+private:
+    std::shared_ptr<Connection> server;
+    std::unique_ptr<Uring>      ring;
+
+    const unsigned int queue_depth;
+    const unsigned int buffer_count;
+    const unsigned int buffer_size;
+
+    BufferPool buffers;
+
+    std::vector<std::unique_ptr<Peer>> peers;
+    size_t                             peer_count;
+
+    Doorbell          doorbell;
+    std::atomic<bool> leave;
+    bool              accepting;
+
+    unsigned int max_requests;
+
+    interfaces::RequestHandler* request_handler;
+    event_callback              callback;
+
+    LoopClock   clock;
+    HeaderCache headers;
+
+public:
+    LinuxUringTcpSocket();
+    LinuxUringTcpSocket(const unsigned int, const unsigned int, const unsigned int);
+    ~LinuxUringTcpSocket() noexcept = default;
+
+    void bind(const char*, const char*);
+    void bind(const char*, const unsigned short);
+
+    /**
+     * @param callback called with a `const HttpRequest*` and a `ResponseWriter*` for
+     *        every request when no request handler is set, may be nullptr
+     */
+    void listen(const unsigned int, event_callback);
+
+    /**
+     * @brief serve until `stop()`, then close every client socket before returning
+     */
+    void open();
+
+    /**
+     * @brief close the listening socket, once `open()` has returned
+     */
+    void close();
+
+    /**
+     * @brief make `open()` return once the connections are closed, safe to call from any thread
+     */
+    void stop();
+
+    /**
+     * @brief requests served on one persistent connection before it is closed
+     */
+    void set_max_requests(const unsigned int);
+
+    /**
+     * @brief who answers requests, ahead of the listen callback
+     */
+    void set_request_handler(interfaces::RequestHandler*);
+
+private:
+    void handle_accept(const io_uring_cqe&);
+    void handle_receive(SOCKET, const io_uring_cqe&);
+    void handle_send(SOCKET, const io_uring_cqe&);
+    void handle_writable(SOCKET, const io_uring_cqe&);
+    bool has_request(Peer*);
+    void reject(Peer*);
+    void process_requests(SOCKET, Peer*);
+    void respond(SOCKET, Peer*);
+    void flush(SOCKET, Peer*);
+    void drain();
+    void release(SOCKET, Peer*);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_LINUX_URING_TCP_SOCKET_HPP__ */
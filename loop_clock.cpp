@@ -0,0 +1,27 @@
+#include "loop_clock.hpp"
+
+#include <time.h>
+
+using namespace nt::http;
+
+LoopClock::LoopClock() :
+      milliseconds(0)
+{
+    update();
+}
+
+void
+LoopClock::update()
+{
+    timespec ts;
+
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    milliseconds = static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+uint64_t
+LoopClock::now() const
+{
+    return milliseconds;
+}
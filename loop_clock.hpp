@@ -0,0 +1,35 @@
+#ifndef HTTPWEBSERVER_SOCKET_LOOP_CLOCK_HPP__
+#define HTTPWEBSERVER_SOCKET_LOOP_CLOCK_HPP__
+
+#include <cstdint>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief monotonic time read once per loop iteration
+ *
+ * Everything handled within one iteration sees the same `now()`, which
+ * saves a clock_gettime per timer operation.
+ */
+class __HttpWebServerSocketPort__ LoopClock
+{
+private:
+    uint64_t milliseconds;
+
+public:
+    LoopClock();
+
+    void update();
+
+    /**
+     * @brief milliseconds since an arbitrary, fixed point
+     */
+    uint64_t now() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_LOOP_CLOCK_HPP__ */
@@ -0,0 +1,38 @@
+#include "mailbox.hpp"
+
+using namespace nt::http;
+
+Mailbox::Mailbox() :
+      handle(doorbell.handle)
+{
+}
+
+void
+Mailbox::post(Command* command)
+{
+    if (queue.push(command)) {
+        doorbell.ring();
+    }
+}
+
+unsigned int
+Mailbox::run()
+{
+    unsigned int count = 0;
+
+    // reset the counter first, a post racing with this either lands in the
+    // batch below or finds the queue empty again and rings once more
+    doorbell.drain();
+
+    Command* command = queue.pop_all();
+
+    while (command != nullptr) {
+        Command* next = command->next;
+
+        command->callback(command->data);
+        command = next;
+        count++;
+    }
+
+    return count;
+}
@@ -0,0 +1,63 @@
+#ifndef HTTPWEBSERVER_SOCKET_MAILBOX_HPP__
+#define HTTPWEBSERVER_SOCKET_MAILBOX_HPP__
+
+#include "common.hpp"
+#include "mpsc_queue.hpp"
+#include "doorbell.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+typedef void (* command_callback)(void*);
+
+/**
+ * @brief work posted to an event loop from another thread
+ *
+ * The poster owns the command and keeps it alive until `callback` has run
+ * on the loop thread; the callback may free it.
+ */
+struct Command
+{
+    Command*         next;
+    command_callback callback;
+    void*            data;
+};
+
+/**
+ * @brief command queue of an event loop plus the eventfd that wakes it
+ *
+ * The doorbell is only rung when a post finds the queue empty, so a burst
+ * of commands costs one write and one read however long it is.
+ */
+class __HttpWebServerSocketPort__ Mailbox
+{
+private:
+    MpscQueue<Command> queue;
+    Doorbell           doorbell;
+
+public:
+    // bound to the doorbell, which has to be constructed first
+    const int& handle;
+
+public:
+    Mailbox();
+    ~Mailbox() noexcept = default;
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
+    /**
+     * @brief queue a command, safe from any thread
+     */
+    void post(Command*);
+
+    /**
+     * @brief run everything posted so far, on the loop thread
+     * @return number of commands run
+     */
+    unsigned int run();
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_MAILBOX_HPP__ */
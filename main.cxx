@@ -7,11 +7,23 @@
 #include "tcp_socket.hpp"
 #include "raw_socket.hpp"
 #include "pipe.hpp"
+#include "response_writer.hpp"
+
+#ifdef LINUX
+#   include "multi_reactor_tcp_socket.hpp"
+#   include "acceptor_tcp_socket.hpp"
+#endif
+#ifdef HAVE_IO_URING
+#   include "linux_uring_tcp_socket.hpp"
+#endif
 
 static void
-callback(void*, void*)
+callback(void*, void* response)
 {
+    auto writer = static_cast<nt::http::ResponseWriter*>(response);
 
+    writer->header("Content-Type", "text/plain; charset=UTF-8");
+    writer->body("hello\n");
 }
 
 static void
@@ -24,10 +36,33 @@ run(nt::http::interfaces::Socket* socket)
     // socket->close();
 }
 
+static std::unique_ptr<nt::http::interfaces::Socket>
+_create_socket(const std::string& backend)
+{
+#ifdef LINUX
+    if (backend == "select") {
+        return std::make_unique<nt::http::LinuxTcpSocket>(nt::http::PollBackend::Select);
+    }
+    if (backend == "reuseport") {
+        return std::make_unique<nt::http::MultiReactorTcpSocket>();
+    }
+    if (backend == "acceptor") {
+        return std::make_unique<nt::http::AcceptorTcpSocket>();
+    }
+#endif
+#ifdef HAVE_IO_URING
+    if (backend == "uring") {
+        return std::make_unique<nt::http::LinuxUringTcpSocket>();
+    }
+#endif
+
+    return std::make_unique<nt::http::TcpSocket>();
+}
+
 static void
-_main()
+_main(const std::string& backend)
 {
-    auto socket = std::make_unique<nt::http::TcpSocket>();
+    auto socket = _create_socket(backend);
     auto s      = dynamic_cast<nt::http::interfaces::Socket*>(socket.get());
 
     if (s == nullptr) {
@@ -73,7 +108,7 @@ _main_raw()
     if (_is_set({FD_ACCEPT}, networkEvents.lNetworkEvents)) {
         std::cout << "accept\n";
 
-        auto client = socket->accept();
+        auto client = std::make_unique<nt::http::RawSocket>(socket->accept());
 
         char buffer[MAX_INPUT] = {0};
 
@@ -82,7 +117,8 @@ _main_raw()
         std::cout << buffer;
     }
 #else
-    auto client = socket->accept();
+    auto client = std::make_unique<nt::http::RawSocket>(socket->accept());
+    client->set_blocking(true);
 
     char buffer[MAX_INPUT] = {0};
 
@@ -93,10 +129,10 @@ _main_raw()
 }
 
 int
-main(int, char**)
+main(int argc, char** argv)
 {
     try {
-        _main();
+        _main(argc > 1 ? argv[1] : "");
         // _main_raw();
         return EXIT_SUCCESS;
     } catch (std::bad_cast& ex) {
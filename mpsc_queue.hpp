@@ -0,0 +1,79 @@
+#ifndef HTTPWEBSERVER_SOCKET_MPSC_QUEUE_HPP__
+#define HTTPWEBSERVER_SOCKET_MPSC_QUEUE_HPP__
+
+#include <atomic>
+
+namespace nt { namespace http {
+
+/**
+ * @brief unbounded lock-free intrusive queue, many producers and one consumer
+ *
+ * `T` needs a `T* next` member. Producers push onto a single atomic head,
+ * the consumer takes the whole batch with one exchange and restores the
+ * order of arrival. Being one exchange, `pop_all()` may also be called
+ * from other threads, each caller gets a batch of its own. A node belongs
+ * to the queue from `push()` until it comes back from `pop_all()`, so it
+ * must not be pushed twice meanwhile.
+ */
+template<typename T>
+class MpscQueue
+{
+private:
+    std::atomic<T*> head;
+
+public:
+    MpscQueue() :
+          head(nullptr)
+    {
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief producer side, safe from any thread
+     * @return true when the queue was empty, i.e. the consumer needs waking
+     */
+    bool
+    push(T* node)
+    {
+        T* top = head.load(std::memory_order_relaxed);
+
+        do {
+            node->next = top;
+        } while (!head.compare_exchange_weak(top, node, std::memory_order_release, std::memory_order_relaxed));
+
+        return top == nullptr;
+    }
+
+    /**
+     * @brief consumer side, safe alongside producers and other consumers
+     * @return everything pushed so far, oldest first, linked through `next`
+     */
+    T*
+    pop_all()
+    {
+        T* node    = head.exchange(nullptr, std::memory_order_acquire);
+        T* ordered = nullptr;
+
+        while (node != nullptr) {
+            T* next = node->next;
+
+            node->next = ordered;
+            ordered    = node;
+            node       = next;
+        }
+
+        return ordered;
+    }
+
+    bool
+    empty() const
+    {
+        return head.load(std::memory_order_relaxed) == nullptr;
+    }
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_MPSC_QUEUE_HPP__ */
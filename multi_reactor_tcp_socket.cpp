@@ -0,0 +1,159 @@
+#include <iostream>
+#include <stdexcept>
+#include <tinythread.h>
+
+#include "multi_reactor_tcp_socket.hpp"
+
+using namespace nt::http;
+
+static unsigned int
+_get_reactor_count(const unsigned int count)
+{
+    if (count != 0) {
+        return count;
+    }
+
+    unsigned int cores = tthread::thread::hardware_concurrency();
+
+    return cores == 0 ? 1 : cores;
+}
+
+static void
+_run_reactor(void* arg)
+{
+    auto reactor = static_cast<LinuxTcpSocket*>(arg);
+
+    try {
+        reactor->open();
+    } catch (std::exception& ex) {
+        std::cerr << "reactor stopped: " << ex.what() << std::endl;
+    }
+}
+
+MultiReactorTcpSocket::MultiReactorTcpSocket(const unsigned int count, PollBackend backend) :
+      reactor_count(_get_reactor_count(count))
+{
+    reactors.reserve(reactor_count);
+
+    for (unsigned int i = 0; i < reactor_count; i++) {
+        reactors.push_back(std::unique_ptr<LinuxTcpSocket>(new LinuxTcpSocket(backend)));
+    }
+}
+
+MultiReactorTcpSocket::~MultiReactorTcpSocket() noexcept
+{
+    for (auto& thread : threads) {
+        if (thread->joinable()) {
+            thread->join();
+        }
+    }
+}
+
+void
+MultiReactorTcpSocket::bind(const char* server_address, const char* service)
+{
+    for (auto& reactor : reactors) {
+        reactor->bind(server_address, service);
+    }
+}
+
+void
+MultiReactorTcpSocket::bind(const char* server_address, const unsigned short port_no)
+{
+    for (auto& reactor : reactors) {
+        reactor->bind(server_address, port_no);
+    }
+}
+
+void
+MultiReactorTcpSocket::listen(const unsigned int count, event_callback callback)
+{
+    for (auto& reactor : reactors) {
+        reactor->listen(count, callback);
+    }
+}
+
+void
+MultiReactorTcpSocket::open()
+{
+    // the calling thread runs the first reactor
+    for (size_t i = 1; i < reactors.size(); i++) {
+        threads.push_back(std::unique_ptr<tthread::thread>(new tthread::thread(_run_reactor, reactors[i].get())));
+    }
+
+    _run_reactor(reactors[0].get());
+
+    for (auto& thread : threads) {
+        thread->join();
+    }
+
+    threads.clear();
+
+    // every loop has returned, nothing else touches the reactors now
+    for (auto& reactor : reactors) {
+        reactor->close();
+    }
+}
+
+void
+MultiReactorTcpSocket::close()
+{
+    for (auto& reactor : reactors) {
+        reactor->stop();
+    }
+}
+
+unsigned int
+MultiReactorTcpSocket::size() const
+{
+    unsigned int count = 0;
+
+    for (auto& reactor : reactors) {
+        count += reactor->size();
+    }
+
+    return count;
+}
+
+void
+MultiReactorTcpSocket::set_request_handler(interfaces::RequestHandler* handler)
+{
+    for (auto& reactor : reactors) {
+        reactor->set_request_handler(handler);
+    }
+}
+
+void
+MultiReactorTcpSocket::set_executor(Executor* executor)
+{
+    for (auto& reactor : reactors) {
+        reactor->set_executor(executor);
+    }
+}
+
+void
+MultiReactorTcpSocket::set_response_cache(const size_t max_entries,
+                                          const unsigned int ttl,
+                                          const std::vector<std::string>& vary)
+{
+    for (auto& reactor : reactors) {
+        reactor->set_response_cache(max_entries, ttl, vary);
+    }
+}
+
+ResponseCacheStats
+MultiReactorTcpSocket::response_cache_stats() const
+{
+    ResponseCacheStats total = {0, 0, 0, 0};
+
+    for (auto& reactor : reactors) {
+        ResponseCacheStats stats = reactor->response_cache_stats();
+
+        total.hits      += stats.hits;
+        total.misses    += stats.misses;
+        total.evictions += stats.evictions;
+        total.entries   += stats.entries;
+    }
+
+    return total;
+}
@@ -0,0 +1,76 @@
+#ifndef HTTPWEBSERVER_MULTI_REACTOR_TCP_SOCKET_HPP__
+#define HTTPWEBSERVER_MULTI_REACTOR_TCP_SOCKET_HPP__
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "common.hpp"
+#include "poller.hpp"
+#include "linux_tcp_socket.hpp"
+#include "interfaces/socket.hpp"
+
+namespace tthread {
+class thread;
+}
+
+namespace nt { namespace http {
+
+/**
+ * @brief one event loop per thread, each with its own listening socket
+ *
+ * Every reactor binds the same address; `SO_REUSEPORT` (set by
+ * RawSocket::bind) lets the kernel spread incoming connections across
+ * them. Reactors share nothing, each keeps its own connection table.
+ */
+class __HttpWebServerSocketPort__ MultiReactorTcpSocket :
+      public nt::http::interfaces::Socket
+{
+private:
+    const unsigned int reactor_count;
+
+    std::vector<std::unique_ptr<LinuxTcpSocket>>  reactors;
+    std::vector<std::unique_ptr<tthread::thread>> threads;
+
+public:
+    /**
+     * @param count number of reactor threads, 0 for the hardware concurrency
+     */
+    explicit MultiReactorTcpSocket(const unsigned int = 0, PollBackend = PollBackend::Epoll);
+    ~MultiReactorTcpSocket() noexcept;
+
+    void bind(const char*, const char*);
+    void bind(const char*, const unsigned short);
+    void listen(const unsigned int, event_callback);
+    void open();
+    void close();
+
+    /**
+     * @brief open client connections over all reactors, safe to read from other threads
+     */
+    unsigned int size() const;
+
+    /**
+     * @brief the same handler for every reactor, it is called from all their threads
+     */
+    void set_request_handler(interfaces::RequestHandler*);
+
+    /**
+     * @brief one executor for the CPU bound requests of every reactor
+     */
+    void set_executor(Executor*);
+
+    /**
+     * @brief give every reactor a response cache of its own, see LinuxTcpSocket::set_response_cache
+     */
+    void set_response_cache(const size_t, const unsigned int, const std::vector<std::string>& = {});
+
+    /**
+     * @brief counters summed over the reactors' caches
+     */
+    ResponseCacheStats response_cache_stats() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_MULTI_REACTOR_TCP_SOCKET_HPP__ */
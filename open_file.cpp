@@ -0,0 +1,52 @@
+#include <ctime>
+#include <cstdio>
+
+#include "open_file.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const size_t DATE_SIZE = 32;
+
+}
+
+OpenFile::OpenFile(const int file, const struct stat& info) :
+      handle(_handle),
+      _handle(file),
+      size(info.st_size),
+      inode(info.st_ino),
+      modified(info.st_mtim.tv_sec),
+      modified_ns(info.st_mtim.tv_nsec)
+{
+    char text[DATE_SIZE * 2];
+
+    // nothing but the inode goes in, a conditional request can be answered without reading the file
+    int length = std::snprintf(text, sizeof(text), "\"%llx-%llx-%llx\"",
+                               static_cast<unsigned long long>(inode),
+                               static_cast<unsigned long long>(size),
+                               static_cast<unsigned long long>(modified) * 1000000000ull + modified_ns);
+
+    etag.assign(text, length);
+
+    std::time_t seconds = modified;
+    std::tm     utc;
+
+    ::gmtime_r(&seconds, &utc);
+
+    last_modified.assign(text, std::strftime(text, sizeof(text), "%a, %d %b %Y %H:%M:%S GMT", &utc));
+}
+
+OpenFile::~OpenFile() noexcept
+{
+    ::close(_handle);
+}
+
+bool
+OpenFile::is_current(const struct stat& info) const
+{
+    return static_cast<uint64_t>(info.st_ino) == inode &&
+           static_cast<uint64_t>(info.st_size) == size &&
+           info.st_mtim.tv_sec == modified &&
+           info.st_mtim.tv_nsec == modified_ns;
+}
@@ -0,0 +1,54 @@
+#ifndef HTTPWEBSERVER_SOCKET_OPEN_FILE_HPP__
+#define HTTPWEBSERVER_SOCKET_OPEN_FILE_HPP__
+
+#include <string>
+#include <cstdint>
+
+#include <sys/stat.h>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief a regular file opened for reading, with the validators derived from its inode
+ */
+class __HttpWebServerSocketPort__ OpenFile
+{
+public:
+    const int& handle;
+private:
+    int _handle;
+
+public:
+    uint64_t size;
+    uint64_t inode;
+    int64_t  modified;
+    long     modified_ns;
+
+    /**
+     * @brief quoted, ready to be sent
+     */
+    std::string etag;
+    std::string last_modified;
+
+public:
+    /**
+     * @brief takes ownership of `handle`, described by `info`
+     */
+    OpenFile(const int, const struct stat&);
+    ~OpenFile() noexcept;
+
+    OpenFile(const OpenFile&) = delete;
+    OpenFile& operator=(const OpenFile&) = delete;
+
+    /**
+     * @brief whether `info` still describes the same contents
+     */
+    bool is_current(const struct stat&) const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_OPEN_FILE_HPP__ */
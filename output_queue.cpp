@@ -0,0 +1,344 @@
+#include "output_queue.hpp"
+
+#include <macros/leave_loop_if.hpp>
+
+#ifdef LINUX
+#   include <sys/uio.h>
+#   include <sys/sendfile.h>
+#
+#   include "open_file.hpp"
+#endif
+
+using namespace nt::http;
+
+namespace {
+
+/**
+ * @brief most segments gathered into one send
+ */
+const size_t MAX_SEGMENTS = 64;
+
+}
+
+OutputQueue::OutputQueue() :
+      first(0),
+      total(0)
+{
+}
+
+void
+OutputQueue::set_pool(BufferPool* pool)
+{
+    bytes.set_pool(pool);
+}
+
+void
+OutputQueue::append(const char* data, const size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+
+    bytes.append(data, size);
+    total += size;
+
+    // while nothing is referenced the buffer alone is the queue
+    if (segments.empty()) {
+        return;
+    }
+
+    Segment& last = segments.back();
+
+    if (last.data == nullptr && last.file == nullptr) {
+        last.size += size;
+    } else {
+        segments.push_back({nullptr, size, nullptr, nullptr, 0});
+    }
+}
+
+void
+OutputQueue::append(const std::string& data)
+{
+    append(data.data(), data.size());
+}
+
+void
+OutputQueue::append(const std::shared_ptr<const std::string>& owner)
+{
+    if (owner->empty()) {
+        return;
+    }
+
+    if (segments.empty() && !bytes.empty()) {
+        segments.push_back({nullptr, bytes.size(), nullptr, nullptr, 0});
+    }
+
+    segments.push_back({owner->data(), owner->size(), owner, nullptr, 0});
+    total += owner->size();
+}
+
+void
+OutputQueue::append(const std::shared_ptr<const OpenFile>& file, const uint64_t offset, const size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+
+    if (segments.empty() && !bytes.empty()) {
+        segments.push_back({nullptr, bytes.size(), nullptr, nullptr, 0});
+    }
+
+    segments.push_back({nullptr, size, nullptr, file, offset});
+    total += size;
+}
+
+void
+OutputQueue::append(OutputQueue& other)
+{
+    if (other.segments.empty()) {
+        append(other.bytes.data(), other.bytes.size());
+        other.clear();
+        return;
+    }
+
+    // copies are copied again, references and files keep pointing where they did
+    size_t copied = 0;
+
+    for (size_t i = other.first; i < other.segments.size(); i++) {
+        Segment& segment = other.segments[i];
+
+        if (segment.data == nullptr && segment.file == nullptr) {
+            append(other.bytes.data() + copied, segment.size);
+            copied += segment.size;
+            continue;
+        }
+
+        if (segments.empty() && !bytes.empty()) {
+            segments.push_back({nullptr, bytes.size(), nullptr, nullptr, 0});
+        }
+
+        segments.push_back(segment);
+        total += segment.size;
+    }
+
+    other.clear();
+}
+
+size_t
+OutputQueue::size() const
+{
+    return total;
+}
+
+bool
+OutputQueue::empty() const
+{
+    return total == 0;
+}
+
+void
+OutputQueue::clear()
+{
+    bytes.clear();
+    segments.clear();
+    first = 0;
+    total = 0;
+}
+
+bool
+OutputQueue::copy_tail(const size_t count, std::string& into) const
+{
+    if (count > total) {
+        return false;
+    }
+
+    size_t remaining = count;
+
+    for (size_t i = segments.size(); i > first && remaining != 0; i--) {
+        const Segment& segment = segments[i - 1];
+
+        if (segment.data != nullptr || segment.file != nullptr) {
+            return false;
+        }
+
+        remaining -= segment.size < remaining ? segment.size : remaining;
+    }
+
+    // copied bytes are kept in order, the tail of the queue is the tail of the buffer
+    into.assign(bytes.data() + bytes.size() - count, count);
+
+    return true;
+}
+
+ssize_t
+OutputQueue::send(SOCKET socket)
+{
+    size_t sent = 0;
+
+    while (!empty()) {
+        size_t  wanted;
+        ssize_t result;
+
+        if (!segments.empty() && segments[first].file != nullptr) {
+            wanted = segments[first].size;
+            result = send_file(socket, segments[first]);
+        } else {
+            result = send_memory(socket, wanted);
+        }
+
+        if (result < 0) {
+            // reported with the next call if something went out already
+            return sent == 0 ? SOCKET_ERROR : static_cast<ssize_t>(sent);
+        }
+
+        consume(result);
+        sent += result;
+
+        // the socket is full
+        if (static_cast<size_t>(result) < wanted) {
+            break;
+        }
+    }
+
+    return sent;
+}
+
+ssize_t
+OutputQueue::send_memory(SOCKET socket, size_t& wanted)
+{
+    wanted = 0;
+
+#ifdef LINUX
+    iovec  vectors[MAX_SEGMENTS];
+    size_t count = 0;
+    int    flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+
+    wanted = gather(vectors, MAX_SEGMENTS, count);
+
+    // hold the headers back until the file follows them
+    if (first + count < segments.size() && segments[first + count].file != nullptr) {
+        flags |= MSG_MORE;
+    }
+
+    msghdr message = {};
+
+    message.msg_iov    = vectors;
+    message.msg_iovlen = count;
+
+    return ::sendmsg(socket, &message, flags);
+#else
+    const Segment* segment = segments.empty() ? nullptr : &segments[first];
+
+    if (segment == nullptr || segment->data == nullptr) {
+        wanted = segment == nullptr ? bytes.size() : segment->size;
+
+        return ::send(socket, bytes.data(), wanted, 0);
+    }
+
+    wanted = segment->size;
+
+    return ::send(socket, segment->data, wanted, 0);
+#endif
+}
+
+#ifdef LINUX
+size_t
+OutputQueue::gather(iovec* vectors, const size_t max, size_t& count) const
+{
+    size_t wanted = 0;
+
+    count = 0;
+
+    if (segments.empty()) {
+        if (!bytes.empty() && max > 0) {
+            vectors[count++] = {const_cast<char*>(bytes.data()), bytes.size()};
+            wanted = bytes.size();
+        }
+
+        return wanted;
+    }
+
+    size_t offset = 0;
+
+    for (size_t i = first; i < segments.size() && count < max; i++) {
+        const Segment& segment = segments[i];
+
+        break_if (segment.file != nullptr);
+
+        if (segment.data == nullptr) {
+            vectors[count++] = {const_cast<char*>(bytes.data() + offset), segment.size};
+            offset += segment.size;
+        } else {
+            vectors[count++] = {const_cast<char*>(segment.data), segment.size};
+        }
+
+        wanted += segment.size;
+    }
+
+    return wanted;
+}
+#endif
+
+ssize_t
+OutputQueue::send_file(SOCKET socket, Segment& segment)
+{
+#ifdef LINUX
+    off_t   offset = segment.offset;
+    ssize_t sent   = ::sendfile(socket, segment.file->handle, &offset, segment.size);
+
+    // the file got shorter than promised, the response cannot be completed
+    if (sent == 0) {
+        errno = EIO;
+
+        return SOCKET_ERROR;
+    }
+
+    return sent;
+#else
+    (void)socket;
+    (void)segment;
+
+    errno = ENOSYS;
+
+    return SOCKET_ERROR;
+#endif
+}
+
+void
+OutputQueue::consume(size_t count)
+{
+    total -= count;
+
+    if (segments.empty()) {
+        bytes.consume(count);
+        return;
+    }
+
+    while (count != 0) {
+        Segment& segment = segments[first];
+        size_t   taken   = count < segment.size ? count : segment.size;
+
+        if (segment.file != nullptr) {
+            segment.offset += taken;
+        } else if (segment.data == nullptr) {
+            bytes.consume(taken);
+        } else {
+            segment.data += taken;
+        }
+
+        segment.size -= taken;
+        count        -= taken;
+
+        if (segment.size == 0) {
+            segment.owner.reset();
+            segment.file.reset();
+            first++;
+        }
+    }
+
+    if (first == segments.size()) {
+        // drained, an idle connection keeps no segment list around
+        std::vector<Segment>().swap(segments);
+        first = 0;
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef HTTPWEBSERVER_SOCKET_OUTPUT_QUEUE_HPP__
+#define HTTPWEBSERVER_SOCKET_OUTPUT_QUEUE_HPP__
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "buffer.hpp"
+
+namespace nt { namespace http {
+
+class OpenFile;
+
+/**
+ * @brief bytes waiting to be sent on a connection, as a list of segments
+ *
+ * Small pieces such as status lines and headers are copied into a pooled
+ * buffer; larger bodies can be queued by reference and stay where they
+ * are until sent, file contents go from the page cache with `sendfile`.
+ * Consecutive memory segments go out with one gathered send, whatever
+ * the socket does not take waits for the next call.
+ */
+class __HttpWebServerSocketPort__ OutputQueue
+{
+private:
+    /**
+     * @brief `data` and `file` are nullptr for the next `size` bytes of the copy buffer
+     */
+    struct Segment
+    {
+        const char* data;
+        size_t      size;
+
+        std::shared_ptr<const std::string> owner;
+        std::shared_ptr<const OpenFile>    file;
+        uint64_t                           offset;
+    };
+
+    Buffer               bytes;
+    std::vector<Segment> segments;
+    size_t               first;
+    size_t               total;
+
+public:
+    OutputQueue();
+    ~OutputQueue() noexcept = default;
+
+    OutputQueue(const OutputQueue&) = delete;
+    OutputQueue& operator=(const OutputQueue&) = delete;
+
+    void set_pool(BufferPool*);
+
+    /**
+     * @brief queue a copy
+     */
+    void append(const char*, const size_t);
+    void append(const std::string&);
+
+    /**
+     * @brief queue bytes without copying them, `owner` keeps them alive until sent
+     */
+    void append(const std::shared_ptr<const std::string>&);
+
+    /**
+     * @brief queue `size` bytes of a file starting at `offset`, sent without passing through user space
+     */
+    void append(const std::shared_ptr<const OpenFile>&, const uint64_t, const size_t);
+
+    /**
+     * @brief move everything queued in `other` to the end of this queue, leaving it empty
+     */
+    void append(OutputQueue&);
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    /**
+     * @brief copy of the last `count` bytes queued
+     * @return false if some of them are referenced or file segments
+     */
+    bool copy_tail(const size_t, std::string&) const;
+
+    /**
+     * @brief send as much as the socket takes without blocking
+     * @return bytes sent, or SOCKET_ERROR with errno set if nothing could be
+     */
+    ssize_t send(SOCKET);
+
+#ifdef LINUX
+    /**
+     * @brief point vectors at the memory at the front of the queue, for a send made elsewhere
+     * @param count set to the vectors filled, none when a file comes first
+     * @return bytes the vectors cover
+     */
+    size_t gather(iovec*, const size_t, size_t&) const;
+#endif
+
+    /**
+     * @brief drop bytes sent elsewhere from the front
+     */
+    void consume(size_t);
+
+private:
+    ssize_t send_memory(SOCKET, size_t&);
+    ssize_t send_file(SOCKET, Segment&);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_OUTPUT_QUEUE_HPP__ */
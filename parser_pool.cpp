@@ -0,0 +1,58 @@
+#include "parser_pool.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const size_t MAX_FREE = 1024;
+
+}
+
+ParserPool::ParserPool() :
+      ParserPool(MAX_FREE)
+{
+}
+
+ParserPool::ParserPool(const size_t free) :
+      max_free(free)
+{
+}
+
+ParserPool::~ParserPool() noexcept
+{
+    for (auto parser : parsers) {
+        delete parser;
+    }
+}
+
+HttpParser*
+ParserPool::acquire()
+{
+    if (parsers.empty()) {
+        return new HttpParser();
+    }
+
+    HttpParser* parser = parsers.back();
+
+    parsers.pop_back();
+
+    return parser;
+}
+
+void
+ParserPool::release(HttpParser* parser)
+{
+    // past the limit a burst is over, the memory goes back to the system
+    if (parsers.size() >= max_free) {
+        delete parser;
+    } else {
+        parser->reset();
+        parsers.push_back(parser);
+    }
+}
+
+size_t
+ParserPool::size() const
+{
+    return parsers.size();
+}
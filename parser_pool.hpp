@@ -0,0 +1,49 @@
+#ifndef HTTPWEBSERVER_SOCKET_PARSER_POOL_HPP__
+#define HTTPWEBSERVER_SOCKET_PARSER_POOL_HPP__
+
+#include <cstddef>
+#include <vector>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "http_parser.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief request parsers shared by the connections of one event loop
+ *
+ * A parser with its header scratch is only held while a request is being
+ * received and answered, idle connections hold none. Released parsers are
+ * kept for reuse, up to a limit. Not thread safe, every loop has its own pool.
+ */
+class __HttpWebServerSocketPort__ ParserPool
+{
+private:
+    size_t max_free;
+
+    std::vector<HttpParser*> parsers;
+
+public:
+    ParserPool();
+    explicit ParserPool(const size_t);
+    ~ParserPool() noexcept;
+
+    ParserPool(const ParserPool&) = delete;
+    ParserPool& operator=(const ParserPool&) = delete;
+
+    /**
+     * @brief a parser ready for a new request
+     */
+    HttpParser* acquire();
+    void release(HttpParser*);
+
+    /**
+     * @brief parsers waiting for reuse
+     */
+    size_t size() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_PARSER_POOL_HPP__ */
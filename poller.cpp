@@ -0,0 +1,16 @@
+#include "poller.hpp"
+
+#include "select_poller.hpp"
+#include "epoll_poller.hpp"
+
+using namespace nt::http;
+
+Poller*
+Poller::create(PollBackend backend)
+{
+    switch (backend) {
+    case PollBackend::Select: return new SelectPoller();
+    case PollBackend::Epoll:
+    default: return new EpollPoller();
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef HTTPWEBSERVER_SOCKET_POLLER_HPP__
+#define HTTPWEBSERVER_SOCKET_POLLER_HPP__
+
+#include "common.hpp"
+#include "timeval.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief readiness notification backend used by the event loop
+ */
+enum class PollBackend
+{
+    Select,
+    Epoll
+};
+
+struct PollEvent
+{
+    SOCKET       socket;
+    unsigned int events;
+    void*        data;
+};
+
+class __HttpWebServerSocketPort__ Poller
+{
+public:
+    static const unsigned int NONE  = 0;
+    static const unsigned int READ  = 1 << 0;
+    static const unsigned int WRITE = 1 << 1;
+    static const unsigned int ERROR = 1 << 2;
+
+public:
+    Poller() = default;
+    virtual ~Poller() noexcept = default;
+
+    static Poller* create(PollBackend);
+
+    /**
+     * @brief register a socket once; `data` is handed back with every event
+     */
+    virtual void add(SOCKET, unsigned int, void*) = 0;
+    virtual void modify(SOCKET, unsigned int, void*) = 0;
+    virtual void remove(SOCKET) = 0;
+
+    /**
+     * @brief wait for at most `count` ready sockets
+     * @return number of events written, 0 on timeout
+     */
+    virtual int wait(PollEvent*, const int, const Timeval&) = 0;
+
+    /**
+     * @brief maximum number of sockets the backend can watch
+     */
+    virtual unsigned int capacity() const = 0;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_POLLER_HPP__ */
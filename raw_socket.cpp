@@ -218,21 +218,48 @@ RawSocket::listen(const unsigned int count)
     }
 }
 
-std::shared_ptr<RawSocket>
-RawSocket::accept()
+void
+RawSocket::set_blocking(const bool blocking)
 {
-    sockaddr_storage client_addr = {0};
+#ifdef LOSE
+    u_long mode = blocking ? 0 : 1;
 
-    sockaddr* addr = reinterpret_cast<sockaddr*>(&client_addr);
-    socklen_t storage_size = sizeof(client_addr);
+    if (::ioctlsocket(_socket, FIONBIO, &mode) == SOCKET_ERROR) {
+        throw std::runtime_error("Failed to change socket blocking mode.");
+    }
+#else
+    int flags = ::fcntl(_socket, F_GETFL, 0);
 
-    int client = ::accept(_socket, addr, &storage_size);
+    if (flags == -1) {
+        throw std::runtime_error("Failed to get socket flags.");
+    }
 
-    return std::make_shared<RawSocket>(client);
+    flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+
+    if (::fcntl(_socket, F_SETFL, flags) == -1) {
+        throw std::runtime_error("Failed to change socket blocking mode.");
+    }
+#endif
+}
+
+SOCKET
+RawSocket::accept()
+{
+#ifdef LOSE
+    return ::accept(_socket, nullptr, nullptr);
+#else
+    // the peer address is looked up on demand, not on every accept
+    return ::accept4(_socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#endif
 }
 
 void
 RawSocket::close()
 {
-    _close_socket(_socket);
+    if (_socket != INVALID_SOCKET) {
+        _close_socket(_socket);
+
+        // the descriptor number may be reused right away, never close it twice
+        _socket = INVALID_SOCKET;
+    }
 }
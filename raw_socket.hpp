@@ -25,7 +25,14 @@ public:
     void bind(const char*, const char*);
     void bind(const char*, const unsigned short);
     void listen(const unsigned int);
-    std::shared_ptr<RawSocket> accept();
+    void set_blocking(const bool);
+
+    /**
+     * @brief accept one pending connection
+     * @return the client handle (non-blocking, close-on-exec on Linux) or
+     *         INVALID_SOCKET with errno set, EAGAIN once the queue is drained
+     */
+    SOCKET accept();
     void close();
 };
 
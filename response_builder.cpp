@@ -0,0 +1,108 @@
+#include "response_builder.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+const size_t DIGITS = 20;
+
+/**
+ * @brief decimal digits of `value`, written backwards from `end`
+ * @return where they start
+ */
+char*
+_format(size_t value, char* end)
+{
+    do {
+        *--end = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    return end;
+}
+
+}
+
+ResponseBuilder::ResponseBuilder(OutputQueue& queue) :
+      output(queue)
+{
+}
+
+void
+ResponseBuilder::status(const unsigned int code, const StringView& reason)
+{
+    char  digits[DIGITS];
+    char* start = _format(code, digits + DIGITS);
+
+    output.append("HTTP/1.1 ", 9);
+    output.append(start, digits + DIGITS - start);
+    output.append(" ", 1);
+    output.append(reason.data(), reason.size());
+    output.append("\r\n", 2);
+}
+
+void
+ResponseBuilder::status(const unsigned int code)
+{
+    StringView line = HeaderCache::status_line(code);
+
+    if (line.empty()) {
+        status(code, "Unknown");
+    } else {
+        append(line);
+    }
+}
+
+void
+ResponseBuilder::append(const StringView& lines)
+{
+    output.append(lines.data(), lines.size());
+}
+
+void
+ResponseBuilder::append(OutputQueue& other)
+{
+    output.append(other);
+}
+
+void
+ResponseBuilder::header(const StringView& name, const StringView& value)
+{
+    output.append(name.data(), name.size());
+    output.append(": ", 2);
+    output.append(value.data(), value.size());
+    output.append("\r\n", 2);
+}
+
+void
+ResponseBuilder::header(const StringView& name, const size_t value)
+{
+    char  digits[DIGITS];
+    char* start = _format(value, digits + DIGITS);
+
+    header(name, StringView(start, digits + DIGITS - start));
+}
+
+void
+ResponseBuilder::end_headers()
+{
+    output.append("\r\n", 2);
+}
+
+void
+ResponseBuilder::body(const StringView& bytes)
+{
+    output.append(bytes.data(), bytes.size());
+}
+
+void
+ResponseBuilder::body(const std::shared_ptr<const std::string>& bytes)
+{
+    output.append(bytes);
+}
+
+void
+ResponseBuilder::body(const std::shared_ptr<const OpenFile>& file, const uint64_t offset, const size_t size)
+{
+    output.append(file, offset, size);
+}
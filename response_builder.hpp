@@ -0,0 +1,68 @@
+#ifndef HTTPWEBSERVER_SOCKET_RESPONSE_BUILDER_HPP__
+#define HTTPWEBSERVER_SOCKET_RESPONSE_BUILDER_HPP__
+
+#include <memory>
+#include <string>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "string_view.hpp"
+#include "output_queue.hpp"
+#include "header_cache.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief writes one response straight into a connection's output queue
+ *
+ * The head is written piece by piece without building temporary strings,
+ * a body can be copied or queued by reference as a segment of its own.
+ */
+class __HttpWebServerSocketPort__ ResponseBuilder
+{
+private:
+    OutputQueue& output;
+
+public:
+    explicit ResponseBuilder(OutputQueue&);
+
+    /**
+     * @brief `HTTP/1.1 <code> <reason>`
+     */
+    void status(const unsigned int, const StringView&);
+
+    /**
+     * @brief the status line with its standard reason, serialized ahead of time for common codes
+     */
+    void status(const unsigned int);
+
+    /**
+     * @brief header lines that are already serialized, CRLFs included
+     */
+    void append(const StringView&);
+
+    /**
+     * @brief whatever was queued in `other`, moved over
+     */
+    void append(OutputQueue&);
+
+    void header(const StringView&, const StringView&);
+    void header(const StringView&, const size_t);
+
+    /**
+     * @brief the blank line, the body follows
+     */
+    void end_headers();
+
+    void body(const StringView&);
+    void body(const std::shared_ptr<const std::string>&);
+
+    /**
+     * @brief `size` bytes of a file from `offset`, sent straight from the page cache
+     */
+    void body(const std::shared_ptr<const OpenFile>&, const uint64_t, const size_t);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_RESPONSE_BUILDER_HPP__ */
@@ -0,0 +1,283 @@
+#include "response_cache.hpp"
+
+#include <macros/leave_loop_if.hpp>
+
+using namespace nt::http;
+
+namespace {
+
+/**
+ * @brief status of a serialized response, 0 if it does not start with a status line
+ */
+unsigned int
+_status_code(const std::string& response)
+{
+    // "HTTP/1.x NNN"
+    if (response.size() < 12 || response.compare(0, 5, "HTTP/") != 0 || response[8] != ' ') {
+        return 0;
+    }
+
+    unsigned int code = 0;
+
+    for (size_t i = 9; i < 12; i++) {
+        if (response[i] < '0' || response[i] > '9') {
+            return 0;
+        }
+
+        code = code * 10 + (response[i] - '0');
+    }
+
+    return code;
+}
+
+StringView
+_trim(StringView value)
+{
+    while (!value.empty() && (value[0] == ' ' || value[0] == '\t')) {
+        value = value.substr(1);
+    }
+
+    while (!value.empty() && (value[value.size() - 1] == ' ' || value[value.size() - 1] == '\t')) {
+        value = value.substr(0, value.size() - 1);
+    }
+
+    return value;
+}
+
+bool
+_is_listed(const StringView& name, const std::vector<std::string>& names)
+{
+    for (auto& listed : names) {
+        if (name.equals_ignore_case(listed)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief whether the headers of a serialized response let it go to other clients
+ *
+ * A cookie or a private response is meant for one client only, a response
+ * varying on a request header the key leaves out could be replayed to a
+ * client that sent a different one.
+ */
+bool
+_is_shareable(const std::string& response, const std::vector<std::string>& vary)
+{
+    size_t end = response.find("\r\n\r\n");
+
+    if (end == std::string::npos) {
+        return false;
+    }
+
+    // every line ends in CRLF, the status line is skipped
+    StringView head(response.data(), end + 2);
+    size_t     at = head.find('\n') + 1;
+
+    while (at < head.size()) {
+        size_t     eol  = head.find('\r', at);
+        StringView line = head.substr(at, eol - at);
+
+        at = eol + 2;
+
+        size_t colon = line.find(':');
+
+        continue_if (colon == StringView::npos);
+
+        StringView name  = line.substr(0, colon);
+        StringView value = line.substr(colon + 1);
+
+        if (name.equals_ignore_case("set-cookie")) {
+            return false;
+        }
+
+        bool is_cache_control = name.equals_ignore_case("cache-control");
+
+        continue_if (!is_cache_control && !name.equals_ignore_case("vary"));
+
+        for (size_t from = 0; from <= value.size();) {
+            size_t comma = value.find(',', from);
+
+            if (comma == StringView::npos) {
+                comma = value.size();
+            }
+
+            StringView token = _trim(value.substr(from, comma - from));
+
+            from = comma + 1;
+
+            continue_if (token.empty());
+
+            if (!is_cache_control) {
+                if (!_is_listed(token, vary)) {
+                    return false;
+                }
+
+                continue;
+            }
+
+            // `no-cache="Set-Cookie"` and the like count as the bare directive
+            StringView directive = token.substr(0, token.find('='));
+
+            if (directive.equals_ignore_case("private") || directive.equals_ignore_case("no-store") || directive.equals_ignore_case("no-cache")) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+}
+
+ResponseCache::ResponseCache(const size_t count, const uint64_t milliseconds, const std::vector<std::string>& headers) :
+      vary(headers),
+      max_entries(count),
+      ttl(milliseconds),
+      hits(0),
+      misses(0),
+      evictions(0),
+      count(0)
+{
+    lru.key  = nullptr;
+    lru.prev = &lru;
+    lru.next = &lru;
+}
+
+bool
+ResponseCache::is_cacheable(const HttpRequest& request) const
+{
+    if (max_entries == 0 || ttl == 0) {
+        return false;
+    }
+
+    if (request.method != StringView("GET") && request.method != StringView("HEAD")) {
+        return false;
+    }
+
+    // the response may be made for the one client only
+    return request.find_header("authorization") == nullptr && request.find_header("cookie") == nullptr;
+}
+
+const std::shared_ptr<const std::string>*
+ResponseCache::find(const HttpRequest& request, const bool keep_alive, const uint64_t now)
+{
+    key.assign(request.method.data(), request.method.size());
+    key += ' ';
+    key.append(request.target.data(), request.target.size());
+
+    // a header that is missing and one that is empty are different keys
+    for (auto& name : vary) {
+        const HttpHeader* header = request.find_header(name);
+
+        if (header == nullptr) {
+            key += '\0';
+        } else {
+            key += '\n';
+            key.append(header->value.data(), header->value.size());
+        }
+    }
+
+    key += keep_alive ? '+' : '-';
+
+    auto found = entries.find(key);
+
+    if (found == entries.end()) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Entry* entry = &found->second;
+
+    if (entry->expires <= now) {
+        erase(entry);
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    unlink(entry);
+    link_front(entry);
+
+    hits.fetch_add(1, std::memory_order_relaxed);
+
+    return &entry->response;
+}
+
+void
+ResponseCache::store(std::string&& response, const uint64_t now)
+{
+    unsigned int code = _status_code(response);
+
+    if (code != 200 && code != 301 && code != 404) {
+        return;
+    } else if (!_is_shareable(response, vary)) {
+        return;
+    }
+
+    auto found = entries.find(key);
+
+    if (found != entries.end()) {
+        erase(&found->second);
+    } else if (entries.size() >= max_entries) {
+        erase(lru.prev);
+    }
+
+    auto inserted = entries.emplace(key, Entry());
+
+    Entry* entry = &inserted.first->second;
+
+    entry->response = std::make_shared<const std::string>(std::move(response));
+    entry->expires  = now + ttl;
+    entry->key      = &inserted.first->first;
+
+    link_front(entry);
+
+    count.store(entries.size(), std::memory_order_relaxed);
+}
+
+ResponseCacheStats
+ResponseCache::stats() const
+{
+    return {
+          hits.load(std::memory_order_relaxed),
+          misses.load(std::memory_order_relaxed),
+          evictions.load(std::memory_order_relaxed),
+          count.load(std::memory_order_relaxed)
+    };
+}
+
+size_t
+ResponseCache::size() const
+{
+    return entries.size();
+}
+
+void
+ResponseCache::link_front(Entry* entry)
+{
+    entry->prev    = &lru;
+    entry->next    = lru.next;
+    lru.next->prev = entry;
+    lru.next       = entry;
+}
+
+void
+ResponseCache::unlink(Entry* entry)
+{
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+}
+
+void
+ResponseCache::erase(Entry* entry)
+{
+    unlink(entry);
+
+    // responses still queued on a connection keep their bytes
+    entries.erase(entries.find(*entry->key));
+
+    evictions.fetch_add(1, std::memory_order_relaxed);
+    count.store(entries.size(), std::memory_order_relaxed);
+}
@@ -0,0 +1,118 @@
+#ifndef HTTPWEBSERVER_SOCKET_RESPONSE_CACHE_HPP__
+#define HTTPWEBSERVER_SOCKET_RESPONSE_CACHE_HPP__
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "string_view.hpp"
+#include "http_parser.hpp"
+
+namespace nt { namespace http {
+
+struct ResponseCacheStats
+{
+    uint64_t hits;
+    uint64_t misses;
+
+    /**
+     * @brief entries dropped, expired or least recently used
+     */
+    uint64_t evictions;
+    size_t   entries;
+};
+
+/**
+ * @brief serialized responses of recent GET and HEAD requests, least recently used first out
+ *
+ * The key is the method, the target, the selected request headers and
+ * whether the connection stays open, so a hit is the exact bytes the
+ * handler would have queued, `Date` line included; it is handed to the
+ * output queue by reference without calling the handler. Only 200, 301
+ * and 404 responses made of copied bytes are kept, and not when they set
+ * a cookie, are marked `private`, `no-store` or `no-cache`, or vary on a
+ * header that is not part of the key. Requests carrying `Authorization`
+ * or `Cookie` always go to the handler.
+ *
+ * Not thread safe, every loop has its own shard. The counters may be
+ * read from any thread.
+ */
+class __HttpWebServerSocketPort__ ResponseCache
+{
+private:
+    struct Entry
+    {
+        std::shared_ptr<const std::string> response;
+        uint64_t                           expires;
+
+        const std::string* key;
+        Entry*             prev;
+        Entry*             next;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+
+    /**
+     * @brief most recently used first, the list head is not an entry
+     */
+    Entry lru;
+
+    std::vector<std::string> vary;
+
+    size_t   max_entries;
+    uint64_t ttl;
+
+    /**
+     * @brief key of the last lookup, reused so a lookup does not allocate
+     */
+    std::string key;
+
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> evictions;
+    std::atomic<size_t>   count;
+
+public:
+    /**
+     * @param max_entries responses kept at most
+     * @param ttl milliseconds a response is served from the cache
+     * @param vary request headers that are part of the key, e.g. `Accept-Encoding`
+     */
+    ResponseCache(const size_t, const uint64_t, const std::vector<std::string>& = {});
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    /**
+     * @brief whether the response to this request may come from, and go into, the cache
+     */
+    bool is_cacheable(const HttpRequest&) const;
+
+    /**
+     * @brief the cached response, nullptr on a miss
+     * @param now milliseconds on the loop clock
+     */
+    const std::shared_ptr<const std::string>* find(const HttpRequest&, const bool, const uint64_t);
+
+    /**
+     * @brief keep a response under the key of the last `find()`, if its status and headers allow
+     */
+    void store(std::string&&, const uint64_t);
+
+    ResponseCacheStats stats() const;
+    size_t size() const;
+
+private:
+    void link_front(Entry*);
+    void unlink(Entry*);
+    void erase(Entry*);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_RESPONSE_CACHE_HPP__ */
@@ -0,0 +1,174 @@
+#include "response_writer.hpp"
+
+using namespace nt::http;
+
+ResponseWriter::ResponseWriter(OutputQueue& output, const HeaderCache& cache, const bool persistent, const bool head) :
+      response(output),
+      headers(cache),
+      state(State::Status),
+      keep_alive(persistent),
+      is_head(head)
+{
+}
+
+void
+ResponseWriter::status(const unsigned int code)
+{
+    if (state != State::Status) {
+        return;
+    }
+
+    response.status(code);
+    state = State::Headers;
+}
+
+void
+ResponseWriter::status(const unsigned int code, const StringView& reason)
+{
+    if (state != State::Status) {
+        return;
+    }
+
+    response.status(code, reason);
+    state = State::Headers;
+}
+
+void
+ResponseWriter::header(const StringView& name, const StringView& value)
+{
+    status(200);
+
+    if (state == State::Headers) {
+        response.header(name, value);
+    }
+}
+
+void
+ResponseWriter::header(const StringView& name, const size_t value)
+{
+    status(200);
+
+    if (state == State::Headers) {
+        response.header(name, value);
+    }
+}
+
+void
+ResponseWriter::close()
+{
+    keep_alive = false;
+}
+
+void
+ResponseWriter::body(const StringView& bytes)
+{
+    if (state == State::Done || state == State::Deferred) {
+        return;
+    }
+
+    end_head(bytes.size());
+
+    if (!is_head) {
+        response.body(bytes);
+    }
+}
+
+void
+ResponseWriter::body(const std::shared_ptr<const std::string>& bytes)
+{
+    if (state == State::Done || state == State::Deferred) {
+        return;
+    }
+
+    end_head(bytes->size());
+
+    if (!is_head) {
+        response.body(bytes);
+    }
+}
+
+void
+ResponseWriter::body(const std::shared_ptr<const OpenFile>& file, const uint64_t offset, const size_t size)
+{
+    if (state == State::Done || state == State::Deferred) {
+        return;
+    }
+
+    end_head(size);
+
+    if (!is_head) {
+        response.body(file, offset, size);
+    }
+}
+
+void
+ResponseWriter::end()
+{
+    if (state == State::Done || state == State::Deferred) {
+        return;
+    }
+
+    end_head(0);
+}
+
+void
+ResponseWriter::send(OutputQueue& other)
+{
+    if (state != State::Status) {
+        return;
+    }
+
+    response.append(other);
+    state = State::Done;
+}
+
+void
+ResponseWriter::defer()
+{
+    if (state == State::Status) {
+        state = State::Deferred;
+    }
+}
+
+void
+ResponseWriter::finish()
+{
+    if (state == State::Deferred) {
+        return;
+    } else if (state == State::Status) {
+        status(500);
+    }
+
+    end();
+}
+
+bool
+ResponseWriter::is_done() const
+{
+    return state == State::Done;
+}
+
+bool
+ResponseWriter::is_deferred() const
+{
+    return state == State::Deferred;
+}
+
+bool
+ResponseWriter::is_keep_alive() const
+{
+    return keep_alive;
+}
+
+void
+ResponseWriter::end_head(const uint64_t size)
+{
+    status(200);
+
+    response.append(headers.server_headers());
+    response.header("Connection", keep_alive ? "keep-alive" : "close");
+    response.header("Content-Length", static_cast<size_t>(size));
+    response.end_headers();
+
+    state = State::Done;
+}
@@ -0,0 +1,112 @@
+#ifndef HTTPWEBSERVER_SOCKET_RESPONSE_WRITER_HPP__
+#define HTTPWEBSERVER_SOCKET_RESPONSE_WRITER_HPP__
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "string_view.hpp"
+#include "header_cache.hpp"
+#include "response_builder.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief the response to one request, written straight into the connection's output queue
+ *
+ * Status and headers go out as they are given; the body call ends the
+ * head with the cached `Server` and `Date` lines, `Connection` and
+ * `Content-Length`, so a handler only sets what is specific to it. A
+ * header before any status implies 200. Nothing is allocated, bytes are
+ * copied into pooled buffers or queued by reference. The body of a
+ * response to HEAD is left out, its length is still announced.
+ */
+class __HttpWebServerSocketPort__ ResponseWriter
+{
+private:
+    enum class State : unsigned char
+    {
+        Status,
+        Headers,
+        Done,
+        Deferred
+    };
+
+    ResponseBuilder    response;
+    const HeaderCache& headers;
+
+    State state;
+    bool  keep_alive;
+    bool  is_head;
+
+public:
+    /**
+     * @param keep_alive whether the connection may stay open after this response
+     * @param is_head whether the request was HEAD
+     */
+    ResponseWriter(OutputQueue&, const HeaderCache&, const bool, const bool);
+
+    ResponseWriter(const ResponseWriter&) = delete;
+    ResponseWriter& operator=(const ResponseWriter&) = delete;
+
+    void status(const unsigned int);
+    void status(const unsigned int, const StringView&);
+
+    void header(const StringView&, const StringView&);
+    void header(const StringView&, const size_t);
+
+    /**
+     * @brief close the connection once this response is sent, before the body is given
+     */
+    void close();
+
+    /**
+     * @brief copy the body and finish the response
+     */
+    void body(const StringView&);
+
+    /**
+     * @brief queue the body by reference and finish the response
+     */
+    void body(const std::shared_ptr<const std::string>&);
+
+    /**
+     * @brief `size` bytes of a file from `offset` as the body, sent with `sendfile`
+     */
+    void body(const std::shared_ptr<const OpenFile>&, const uint64_t, const size_t);
+
+    /**
+     * @brief finish the response without a body
+     */
+    void end();
+
+    /**
+     * @brief a whole response written into another queue, moved over as this one
+     */
+    void send(OutputQueue&);
+
+    /**
+     * @brief the response comes later, through the socket's `complete()`
+     *
+     * Nothing may have been written yet. Requests behind this one wait.
+     */
+    void defer();
+
+    /**
+     * @brief complete whatever the handler left, a response that was never started becomes a 500
+     */
+    void finish();
+
+    bool is_done() const;
+    bool is_deferred() const;
+    bool is_keep_alive() const;
+
+private:
+    void end_head(const uint64_t);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_RESPONSE_WRITER_HPP__ */
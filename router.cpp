@@ -0,0 +1,339 @@
+#include "router.hpp"
+
+#include <stdexcept>
+#include <cstring>
+
+#include "http_parser.hpp"
+#include "response_writer.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+StringView
+_get_path(const StringView& target)
+{
+    size_t query = target.find('?');
+
+    return query == StringView::npos ? target : target.substr(0, query);
+}
+
+/**
+ * @brief whether a `:name` or `*name` segment starts here
+ */
+bool
+_is_parameter(const StringView& pattern, const size_t at)
+{
+    return at > 0 && pattern[at - 1] == '/' && (pattern[at] == ':' || pattern[at] == '*');
+}
+
+}
+
+const StringView*
+RouteMatch::find_param(const StringView& name) const
+{
+    for (size_t i = 0; i < param_count; i++) {
+        if (params[i].name == name) {
+            return &params[i].value;
+        }
+    }
+
+    return nullptr;
+}
+
+Router::Router()
+{
+    add_node(StringView());
+}
+
+void
+Router::add(const StringView& method, const StringView& pattern, route_callback callback, void* data)
+{
+    if (pattern.empty() || pattern[0] != '/') {
+        throw std::runtime_error("Route pattern does not start with '/'.");
+    }
+
+    uint32_t index  = 0;
+    size_t   params = 0;
+    size_t   at     = 0;
+
+    while (at < pattern.size()) {
+        size_t end = at + 1;
+
+        if (!_is_parameter(pattern, at)) {
+            while (end < pattern.size() && !_is_parameter(pattern, end)) {
+                end++;
+            }
+
+            index = insert_literal(index, pattern.substr(at, end - at));
+            at    = end;
+            continue;
+        }
+
+        end = pattern.find('/', at);
+
+        if (end == StringView::npos) {
+            end = pattern.size();
+        }
+
+        bool is_rest = pattern[at] == '*';
+
+        if (end == at + 1) {
+            throw std::runtime_error("Route parameter without a name.");
+        } else if (is_rest && end != pattern.size()) {
+            throw std::runtime_error("Route parameter '*' is not the last segment.");
+        } else if (++params > RouteMatch::MAX_PARAMS) {
+            throw std::runtime_error("Too many route parameters.");
+        }
+
+        index = insert_parameter(index, pattern.substr(at + 1, end - at - 1), is_rest);
+        at    = end;
+    }
+
+    for (auto& route : nodes[index].routes) {
+        if (StringView(route.method) == method) {
+            throw std::runtime_error("Route added twice.");
+        }
+    }
+
+    nodes[index].routes.push_back({std::string(method.data(), method.size()), callback, data});
+}
+
+bool
+Router::match(const StringView& method, const StringView& target, RouteMatch& match) const
+{
+    match.param_count = 0;
+
+    uint32_t fallback = 0;
+    uint32_t index    = find(0, _get_path(target), method, match, fallback);
+
+    if (index == 0) {
+        return false;
+    }
+
+    const Route* route = find_route(nodes[index], method);
+
+    match.callback = route->callback;
+    match.data     = route->data;
+
+    return true;
+}
+
+void
+Router::on_request(Connection* connection, const HttpRequest& request, ResponseWriter& writer)
+{
+    RouteMatch match;
+
+    match.param_count = 0;
+
+    uint32_t fallback = 0;
+    uint32_t index    = find(0, _get_path(request.target), request.method, match, fallback);
+
+    if (index == 0 && fallback == 0) {
+        writer.status(404);
+        writer.end();
+        return;
+    }
+
+    if (index == 0) {
+        std::string allow;
+
+        for (auto& other : nodes[fallback].routes) {
+            if (!allow.empty()) {
+                allow += ", ";
+            }
+
+            allow += other.method;
+        }
+
+        // HEAD is answered by the GET route unless it has its own
+        if (find_route(nodes[fallback], "HEAD") != nullptr && allow.find("HEAD") == std::string::npos) {
+            allow += ", HEAD";
+        }
+
+        writer.status(405);
+        writer.header("Allow", allow);
+        writer.end();
+        return;
+    }
+
+    const Route* route = find_route(nodes[index], request.method);
+
+    match.callback = route->callback;
+    match.data     = route->data;
+
+    route->callback(connection, request, match, writer);
+}
+
+uint32_t
+Router::add_node(const StringView& text)
+{
+    nodes.push_back(Node());
+
+    Node& node = nodes.back();
+
+    node.text.assign(text.data(), text.size());
+    node.parameter = 0;
+    node.rest      = 0;
+
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+uint32_t
+Router::insert_literal(uint32_t index, StringView text)
+{
+    while (!text.empty()) {
+        size_t at = nodes[index].first.find(text[0]);
+
+        if (at == std::string::npos) {
+            uint32_t child = add_node(text);
+
+            nodes[index].first += text[0];
+            nodes[index].children.push_back(child);
+
+            return child;
+        }
+
+        uint32_t child  = nodes[index].children[at];
+        size_t   common = 0;
+
+        while (common < nodes[child].text.size() && common < text.size() && nodes[child].text[common] == text[common]) {
+            common++;
+        }
+
+        // the edge goes on past the new pattern, it is cut in two and the child keeps its index
+        if (common < nodes[child].text.size()) {
+            std::string tail_text = nodes[child].text.substr(common);
+            uint32_t    tail      = add_node(tail_text);
+
+            Node& upper = nodes[child];
+            Node& lower = nodes[tail];
+
+            lower.first.swap(upper.first);
+            lower.children.swap(upper.children);
+            lower.routes.swap(upper.routes);
+            lower.parameter = upper.parameter;
+            lower.rest      = upper.rest;
+
+            upper.text.resize(common);
+            upper.first.assign(1, lower.text[0]);
+            upper.children.assign(1, tail);
+            upper.parameter = 0;
+            upper.rest      = 0;
+        }
+
+        index = child;
+        text  = text.substr(common);
+    }
+
+    return index;
+}
+
+uint32_t
+Router::insert_parameter(const uint32_t index, const StringView& name, const bool is_rest)
+{
+    uint32_t existing = is_rest ? nodes[index].rest : nodes[index].parameter;
+
+    if (existing != 0) {
+        // one path segment cannot be called two things
+        if (StringView(nodes[existing].text) != name) {
+            throw std::runtime_error("Route parameter named differently at the same place.");
+        }
+
+        return existing;
+    }
+
+    uint32_t child = add_node(name);
+
+    if (is_rest) {
+        nodes[index].rest = child;
+    } else {
+        nodes[index].parameter = child;
+    }
+
+    return child;
+}
+
+uint32_t
+Router::find(const uint32_t index, const StringView& path, const StringView& method, RouteMatch& match, uint32_t& fallback) const
+{
+    const Node& node = nodes[index];
+
+    // a path with routes for other methods only is kept for the 405, a less specific one may still fit
+    if (path.empty() && !node.routes.empty()) {
+        if (find_route(node, method) != nullptr) {
+            return index;
+        } else if (fallback == 0) {
+            fallback = index;
+        }
+    }
+
+    if (!path.empty()) {
+        size_t at = node.first.find(path[0]);
+
+        if (at != std::string::npos) {
+            uint32_t           child = node.children[at];
+            const std::string& edge  = nodes[child].text;
+
+            if (path.size() >= edge.size() && std::memcmp(path.data(), edge.data(), edge.size()) == 0) {
+                uint32_t found = find(child, path.substr(edge.size()), method, match, fallback);
+
+                if (found != 0) {
+                    return found;
+                }
+            }
+        }
+    }
+
+    size_t count = match.param_count;
+
+    if (node.parameter != 0) {
+        size_t end = path.find('/');
+
+        if (end == StringView::npos) {
+            end = path.size();
+        }
+
+        if (end != 0) {
+            match.params[count] = {nodes[node.parameter].text, path.substr(0, end)};
+            match.param_count   = count + 1;
+
+            uint32_t found = find(node.parameter, path.substr(end), method, match, fallback);
+
+            if (found != 0) {
+                return found;
+            }
+
+            match.param_count = count;
+        }
+    }
+
+    if (node.rest != 0 && !nodes[node.rest].routes.empty()) {
+        if (find_route(nodes[node.rest], method) != nullptr) {
+            match.params[count] = {nodes[node.rest].text, path};
+            match.param_count   = count + 1;
+
+            return node.rest;
+        } else if (fallback == 0) {
+            fallback = node.rest;
+        }
+    }
+
+    return 0;
+}
+
+const Router::Route*
+Router::find_route(const Node& node, const StringView& method)
+{
+    const Route* get = nullptr;
+
+    for (auto& route : node.routes) {
+        if (StringView(route.method) == method) {
+            return &route;
+        } else if (route.method == "GET") {
+            get = &route;
+        }
+    }
+
+    return method == StringView("HEAD") ? get : nullptr;
+}
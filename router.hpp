@@ -0,0 +1,127 @@
+#ifndef HTTPWEBSERVER_SOCKET_ROUTER_HPP__
+#define HTTPWEBSERVER_SOCKET_ROUTER_HPP__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "interfaces/request_handler.hpp"
+#include "string_view.hpp"
+
+namespace nt { namespace http {
+
+struct RouteMatch;
+
+typedef void (* route_callback)(Connection*, const HttpRequest&, const RouteMatch&, ResponseWriter&);
+
+struct RouteParam
+{
+    StringView name;
+    StringView value;
+};
+
+/**
+ * @brief the route a path matched and the parameters taken from it
+ *
+ * Values point into the request target, they are not percent-decoded.
+ */
+struct RouteMatch
+{
+    static const size_t MAX_PARAMS = 8;
+
+    route_callback callback;
+    void*          data;
+
+    RouteParam params[MAX_PARAMS];
+    size_t     param_count;
+
+    /**
+     * @return nullptr when there is no such parameter
+     */
+    const StringView* find_param(const StringView&) const;
+};
+
+/**
+ * @brief sends requests to callbacks by method and path, through a radix trie
+ *
+ * Patterns are literal paths with `:name` for one path segment, e.g.
+ * `/users/:id/posts`, and a last segment `*name` for the rest. Matching
+ * walks the path once, literal edges are picked by their first byte;
+ * a literal beats a parameter beats a rest, with a step back when the
+ * more specific branch goes nowhere or has no route for the method. The
+ * query string is not part of the path. A path without a route for the
+ * method gets a 405 listing the ones it has, HEAD falling back to GET;
+ * no route at all is a 404.
+ *
+ * Routes are added before the loop starts, matching is read only and
+ * safe from several threads.
+ */
+class __HttpWebServerSocketPort__ Router :
+      public interfaces::RequestHandler
+{
+private:
+    struct Route
+    {
+        std::string    method;
+        route_callback callback;
+        void*          data;
+    };
+
+    struct Node
+    {
+        /**
+         * @brief literal bytes of the edge into this node, the parameter name of a parameter node
+         */
+        std::string text;
+
+        /**
+         * @brief first byte of each literal child, in the order of `children`
+         */
+        std::string           first;
+        std::vector<uint32_t> children;
+
+        // 0 for none, the root is nobody's child
+        uint32_t parameter;
+        uint32_t rest;
+
+        std::vector<Route> routes;
+    };
+
+    std::vector<Node> nodes;
+
+public:
+    Router();
+
+    /**
+     * @brief route requests with this method whose path matches the pattern
+     * @throw std::runtime_error if the pattern is malformed or clashes with an earlier one
+     */
+    void add(const StringView&, const StringView&, route_callback, void* = nullptr);
+
+    /**
+     * @param target request target, the query string is ignored
+     * @return false when nothing matches the path or the method
+     */
+    bool match(const StringView&, const StringView&, RouteMatch&) const;
+
+    void on_request(Connection*, const HttpRequest&, ResponseWriter&) override;
+
+private:
+    uint32_t add_node(const StringView&);
+    uint32_t insert_literal(uint32_t, StringView);
+    uint32_t insert_parameter(const uint32_t, const StringView&, const bool);
+
+    /**
+     * @param fallback set to the first node the path ends in that has no route for the method
+     * @return the node the rest of the path ends in with a route for the method, 0 for none
+     */
+    uint32_t find(const uint32_t, const StringView&, const StringView&, RouteMatch&, uint32_t&) const;
+
+    static const Route* find_route(const Node&, const StringView&);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_ROUTER_HPP__ */
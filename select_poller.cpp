@@ -0,0 +1,119 @@
+#include "select_poller.hpp"
+
+#include <stdexcept>
+
+#include <macros/leave_loop_if.hpp>
+
+using namespace nt::http;
+
+SelectPoller::SelectPoller() :
+      last_socket(INVALID_SOCKET),
+      data(FD_SETSIZE, nullptr)
+{
+    FD_ZERO(&read_set);
+    FD_ZERO(&write_set);
+    FD_ZERO(&error_set);
+}
+
+void
+SelectPoller::add(SOCKET socket, unsigned int events, void* user_data)
+{
+    if (socket < 0 || socket >= FD_SETSIZE) {
+        throw std::runtime_error("Socket does not fit in the select set.");
+    }
+
+    FD_SET(socket, &error_set);
+
+    modify(socket, events, user_data);
+
+    if (socket > last_socket) {
+        last_socket = socket;
+    }
+}
+
+void
+SelectPoller::modify(SOCKET socket, unsigned int events, void* user_data)
+{
+    if (events & READ) {
+        FD_SET(socket, &read_set);
+    } else {
+        FD_CLR(socket, &read_set);
+    }
+
+    if (events & WRITE) {
+        FD_SET(socket, &write_set);
+    } else {
+        FD_CLR(socket, &write_set);
+    }
+
+    data[socket] = user_data;
+}
+
+void
+SelectPoller::remove(SOCKET socket)
+{
+    FD_CLR(socket, &read_set);
+    FD_CLR(socket, &write_set);
+    FD_CLR(socket, &error_set);
+
+    data[socket] = nullptr;
+
+    while (last_socket != INVALID_SOCKET && !FD_ISSET(last_socket, &error_set)) {
+        last_socket--;
+    }
+}
+
+int
+SelectPoller::wait(PollEvent* events, const int count, const Timeval& timeout)
+{
+    read_list  = read_set;
+    write_list = write_set;
+    error_list = error_set;
+
+    Timeval remaining = timeout;
+
+    int select_result = ::select(last_socket + 1, &read_list, &write_list, &error_list, remaining);
+
+    if (select_result == SOCKET_ERROR) {
+        if (errno == EINTR) {
+            return 0;
+        }
+
+        throw std::runtime_error("Failed to poll connections.");
+    }
+
+    int ready = 0;
+
+    for (SOCKET socket = 0; socket <= last_socket && ready < count && select_result > 0; socket++) {
+        unsigned int flags = NONE;
+
+        if (FD_ISSET(socket, &read_list)) {
+            flags |= READ;
+        }
+
+        if (FD_ISSET(socket, &write_list)) {
+            flags |= WRITE;
+        }
+
+        if (FD_ISSET(socket, &error_list)) {
+            flags |= ERROR;
+        }
+
+        continue_if (flags == NONE);
+
+        events[ready].socket = socket;
+        events[ready].events = flags;
+        events[ready].data   = data[socket];
+
+        ready++;
+        select_result--;
+    }
+
+    return ready;
+}
+
+unsigned int
+SelectPoller::capacity() const
+{
+    return FD_SETSIZE - 1;
+}
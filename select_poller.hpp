@@ -0,0 +1,40 @@
+#ifndef HTTPWEBSERVER_SOCKET_SELECT_POLLER_HPP__
+#define HTTPWEBSERVER_SOCKET_SELECT_POLLER_HPP__
+
+#include <vector>
+
+#include "common.hpp"
+#include "poller.hpp"
+
+namespace nt { namespace http {
+
+class __HttpWebServerSocketPort__ SelectPoller :
+      public Poller
+{
+private:
+    fd_set read_set;
+    fd_set write_set;
+    fd_set error_set;
+
+    fd_set read_list;
+    fd_set write_list;
+    fd_set error_list;
+
+    SOCKET last_socket;
+
+    std::vector<void*> data;
+
+public:
+    SelectPoller();
+    ~SelectPoller() noexcept = default;
+
+    void add(SOCKET, unsigned int, void*);
+    void modify(SOCKET, unsigned int, void*);
+    void remove(SOCKET);
+    int wait(PollEvent*, const int, const Timeval&);
+    unsigned int capacity() const;
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_SELECT_POLLER_HPP__ */
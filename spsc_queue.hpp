@@ -0,0 +1,117 @@
+#ifndef HTTPWEBSERVER_SOCKET_SPSC_QUEUE_HPP__
+#define HTTPWEBSERVER_SOCKET_SPSC_QUEUE_HPP__
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+namespace nt { namespace http {
+
+/**
+ * @brief bounded lock-free queue for exactly one producer and one consumer
+ *
+ * Capacity is rounded up to a power of two. Producer and consumer indices
+ * live on separate cache lines and each side caches the other's index so
+ * the shared line is only read when the cached value says full/empty.
+ */
+template<typename T>
+class SpscQueue
+{
+private:
+    static const size_t CACHE_LINE = 64;
+
+    std::vector<T> slots;
+    const size_t   mask;
+
+    // padding instead of alignas, over-aligned new is C++17
+    char                pad0[CACHE_LINE];
+    std::atomic<size_t> head;
+    size_t              cached_tail;
+    char                pad1[CACHE_LINE];
+    std::atomic<size_t> tail;
+    size_t              cached_head;
+    char                pad2[CACHE_LINE];
+
+private:
+    static size_t
+    round_up(size_t capacity)
+    {
+        size_t size = 2;
+
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        return size;
+    }
+
+public:
+    explicit SpscQueue(const size_t capacity) :
+          slots(round_up(capacity)),
+          mask(slots.size() - 1),
+          head(0),
+          cached_tail(0),
+          tail(0),
+          cached_head(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief producer side
+     * @return false when the queue is full
+     */
+    bool
+    push(const T& value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+
+        if (t - cached_head > mask) {
+            cached_head = head.load(std::memory_order_acquire);
+
+            if (t - cached_head > mask) {
+                return false;
+            }
+        }
+
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief consumer side
+     * @return false when the queue is empty
+     */
+    bool
+    pop(T& value)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+
+        if (h == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+
+            if (h == cached_tail) {
+                return false;
+            }
+        }
+
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    size_t
+    capacity() const
+    {
+        return slots.size();
+    }
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_SPSC_QUEUE_HPP__ */
@@ -0,0 +1,494 @@
+#include <ctime>
+#include <cstdio>
+#include <cstdint>
+
+#include "static_files.hpp"
+
+using namespace nt::http;
+
+namespace {
+
+struct ContentType
+{
+    const char* extension;
+    const char* type;
+};
+
+const ContentType CONTENT_TYPES[] = {
+    {"html",  "text/html; charset=UTF-8"},
+    {"htm",   "text/html; charset=UTF-8"},
+    {"css",   "text/css; charset=UTF-8"},
+    {"js",    "text/javascript; charset=UTF-8"},
+    {"json",  "application/json"},
+    {"txt",   "text/plain; charset=UTF-8"},
+    {"xml",   "application/xml"},
+    {"svg",   "image/svg+xml"},
+    {"png",   "image/png"},
+    {"jpg",   "image/jpeg"},
+    {"jpeg",  "image/jpeg"},
+    {"gif",   "image/gif"},
+    {"webp",  "image/webp"},
+    {"ico",   "image/x-icon"},
+    {"woff",  "font/woff"},
+    {"woff2", "font/woff2"},
+    {"wasm",  "application/wasm"},
+    {"pdf",   "application/pdf"},
+    {"mp4",   "video/mp4"},
+    {"webm",  "video/webm"},
+    {"mp3",   "audio/mpeg"},
+};
+
+const char DEFAULT_TYPE[] = "application/octet-stream";
+const char INDEX[]        = "index.html";
+
+const size_t RANGE_SIZE = 96;
+
+StringView
+_content_type(const std::string& path)
+{
+    size_t dot   = path.rfind('.');
+    size_t slash = path.rfind('/');
+
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return DEFAULT_TYPE;
+    }
+
+    StringView extension(path.data() + dot + 1, path.size() - dot - 1);
+
+    for (const auto& type : CONTENT_TYPES) {
+        if (extension.equals_ignore_case(type.extension)) {
+            return type.type;
+        }
+    }
+
+    return DEFAULT_TYPE;
+}
+
+int
+_hex(const char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+StringView
+_trim(const StringView& value)
+{
+    size_t start = 0;
+    size_t end   = value.size();
+
+    while (start < end && (value[start] == ' ' || value[start] == '\t')) {
+        start++;
+    }
+
+    while (end > start && (value[end - 1] == ' ' || value[end - 1] == '\t')) {
+        end--;
+    }
+
+    return value.substr(start, end - start);
+}
+
+/**
+ * @brief weak comparison against each tag of an If-None-Match list
+ */
+bool
+_matches_etag(const StringView& list, const std::string& etag)
+{
+    size_t start = 0;
+
+    while (start <= list.size()) {
+        size_t     comma = list.find(',', start);
+        size_t     end   = comma == StringView::npos ? list.size() : comma;
+        StringView tag   = _trim(list.substr(start, end - start));
+
+        if (tag.size() > 2 && tag[0] == 'W' && tag[1] == '/') {
+            tag = tag.substr(2);
+        }
+
+        if (tag == "*" || tag == StringView(etag)) {
+            return true;
+        }
+
+        start = end + 1;
+    }
+
+    return false;
+}
+
+bool
+_is_not_modified(const HttpRequest& request, const OpenFile& file)
+{
+    const HttpHeader* none_match = request.find_header("if-none-match");
+
+    // the tag decides when there is one, the date is only looked at without it
+    if (none_match != nullptr) {
+        return _matches_etag(none_match->value, file.etag);
+    }
+
+    const HttpHeader* modified_since = request.find_header("if-modified-since");
+
+    // clients send back the date they were given, an exact match is enough
+    return modified_since != nullptr && _trim(modified_since->value) == StringView(file.last_modified);
+}
+
+/**
+ * @brief whether a Range may be applied, it is ignored when If-Range names another version
+ */
+bool
+_is_range_current(const HttpRequest& request, const OpenFile& file)
+{
+    const HttpHeader* if_range = request.find_header("if-range");
+
+    if (if_range == nullptr) {
+        return true;
+    }
+
+    StringView validator = _trim(if_range->value);
+
+    // a weak tag never matches here, ranges of different contents must not be mixed
+    return validator == StringView(file.etag) || validator == StringView(file.last_modified);
+}
+
+bool
+_parse_number(const StringView& text, uint64_t& value)
+{
+    if (text.empty()) {
+        return false;
+    }
+
+    value = 0;
+
+    for (char c : text) {
+        if (c < '0' || c > '9' || value > (UINT64_MAX - 9) / 10) {
+            return false;
+        }
+
+        value = value * 10 + (c - '0');
+    }
+
+    return true;
+}
+
+/**
+ * @brief the satisfiable ranges of a `bytes=` Range value, clamped to the file
+ * @return how many there are, or -1 if the header is to be ignored
+ */
+int
+_parse_ranges(const StringView& value, const uint64_t size, ByteRange* ranges, const size_t max_ranges)
+{
+    StringView list = _trim(value);
+    int        count = 0;
+
+    if (list.size() < 6 || !list.substr(0, 6).equals_ignore_case("bytes=")) {
+        return -1;
+    }
+
+    list = list.substr(6);
+
+    size_t start = 0;
+
+    while (start <= list.size()) {
+        size_t     comma = list.find(',', start);
+        size_t     end   = comma == StringView::npos ? list.size() : comma;
+        StringView spec  = _trim(list.substr(start, end - start));
+
+        start = end + 1;
+
+        // empty list elements are allowed
+        if (spec.empty()) {
+            continue;
+        }
+
+        size_t dash = spec.find('-');
+
+        if (dash == StringView::npos) {
+            return -1;
+        }
+
+        uint64_t first;
+        uint64_t last;
+
+        if (dash == 0) {
+            uint64_t suffix;
+
+            if (!_parse_number(spec.substr(1), suffix)) {
+                return -1;
+            } else if (suffix == 0 || size == 0) {
+                continue;
+            }
+
+            first = suffix < size ? size - suffix : 0;
+            last  = size - 1;
+        } else {
+            if (!_parse_number(spec.substr(0, dash), first)) {
+                return -1;
+            }
+
+            if (dash + 1 == spec.size()) {
+                last = UINT64_MAX;
+            } else if (!_parse_number(spec.substr(dash + 1), last) || last < first) {
+                return -1;
+            }
+
+            if (first >= size) {
+                continue;
+            }
+
+            last = last < size - 1 ? last : size - 1;
+        }
+
+        // a client asking for this many pieces gets the whole file instead
+        if (static_cast<size_t>(count) == max_ranges) {
+            return -1;
+        }
+
+        ranges[count++] = {first, last};
+    }
+
+    return count;
+}
+
+void
+_end_head(ResponseBuilder& response, const HeaderCache& headers, const bool keep_alive)
+{
+    response.append(headers.server_headers());
+    response.header("Connection", keep_alive ? "keep-alive" : "close");
+    response.end_headers();
+}
+
+void
+_empty(ResponseBuilder& response, const HeaderCache& headers, const bool keep_alive, const unsigned int code)
+{
+    response.status(code);
+
+    if (code == 405) {
+        response.header("Allow", "GET, HEAD");
+    }
+
+    response.header("Content-Length", static_cast<size_t>(0));
+
+    _end_head(response, headers, keep_alive);
+}
+
+}
+
+StaticFiles::StaticFiles(const std::string& directory) :
+      root(directory),
+      boundaries(static_cast<uint64_t>(std::time(nullptr)) ^ reinterpret_cast<uintptr_t>(this))
+{
+    // targets start with a slash of their own
+    while (!root.empty() && root.back() == '/') {
+        root.pop_back();
+    }
+}
+
+bool
+StaticFiles::resolve(const StringView& target)
+{
+    StringView location = target.substr(0, target.find('?'));
+
+    if (location.empty() || location[0] != '/') {
+        return false;
+    }
+
+    path.assign(root);
+
+    size_t segment = path.size();
+
+    for (size_t i = 0; i < location.size(); i++) {
+        char c = location[i];
+
+        if (c == '%') {
+            int high = i + 2 < location.size() ? _hex(location[i + 1]) : -1;
+            int low  = i + 2 < location.size() ? _hex(location[i + 2]) : -1;
+
+            if (high < 0 || low < 0 || (high == 0 && low == 0)) {
+                return false;
+            }
+
+            c  = static_cast<char>(high * 16 + low);
+            i += 2;
+        }
+
+        if (c == '/') {
+            // checked after decoding, an escaped dot is still a dot
+            if (path.compare(segment, std::string::npos, "/..") == 0) {
+                return false;
+            }
+
+            segment = path.size();
+        }
+
+        path.push_back(c);
+    }
+
+    if (path.compare(segment, std::string::npos, "/..") == 0) {
+        return false;
+    }
+
+    if (path.back() == '/') {
+        path.append(INDEX);
+    }
+
+    return true;
+}
+
+void
+StaticFiles::serve(const HttpRequest& request,
+                   ResponseBuilder& response,
+                   const HeaderCache& headers,
+                   const bool keep_alive,
+                   const uint64_t now)
+{
+    bool is_head = request.method == "HEAD";
+
+    if (!is_head && request.method != "GET") {
+        _empty(response, headers, keep_alive, 405);
+        return;
+    }
+
+    std::shared_ptr<const OpenFile> file = resolve(request.target) ? cache.open(path, now) : nullptr;
+
+    if (file == nullptr) {
+        _empty(response, headers, keep_alive, 404);
+        return;
+    }
+
+    if (_is_not_modified(request, *file)) {
+        response.status(304);
+        response.header("ETag", file->etag);
+        response.header("Last-Modified", file->last_modified);
+
+        _end_head(response, headers, keep_alive);
+        return;
+    }
+
+    const HttpHeader* range = is_head ? nullptr : request.find_header("range");
+
+    if (range != nullptr && _is_range_current(request, *file)) {
+        ByteRange ranges[MAX_RANGES];
+
+        int count = _parse_ranges(range->value, file->size, ranges, MAX_RANGES);
+
+        if (count == 0) {
+            char content_range[RANGE_SIZE];
+            int  length = std::snprintf(content_range, sizeof(content_range), "bytes */%llu",
+                                        static_cast<unsigned long long>(file->size));
+
+            response.status(416);
+            response.header("Content-Range", StringView(content_range, length));
+            response.header("Content-Length", static_cast<size_t>(0));
+
+            _end_head(response, headers, keep_alive);
+            return;
+        } else if (count > 0) {
+            serve_ranges(file, ranges, count, response, headers, keep_alive);
+            return;
+        }
+    }
+
+    response.status(200);
+    response.header("Content-Type", _content_type(path));
+    response.header("Content-Length", static_cast<size_t>(file->size));
+    response.header("Accept-Ranges", "bytes");
+    response.header("ETag", file->etag);
+    response.header("Last-Modified", file->last_modified);
+
+    _end_head(response, headers, keep_alive);
+
+    if (!is_head) {
+        response.body(file, 0, file->size);
+    }
+}
+
+void
+StaticFiles::serve_ranges(const std::shared_ptr<const OpenFile>& file,
+                          const ByteRange* ranges,
+                          const size_t count,
+                          ResponseBuilder& response,
+                          const HeaderCache& headers,
+                          const bool keep_alive)
+{
+    StringView        type = _content_type(path);
+    unsigned long long size = file->size;
+
+    char content_range[RANGE_SIZE];
+    int  length;
+
+    if (count == 1) {
+        length = std::snprintf(content_range, sizeof(content_range), "bytes %llu-%llu/%llu",
+                               static_cast<unsigned long long>(ranges[0].first),
+                               static_cast<unsigned long long>(ranges[0].last),
+                               size);
+
+        response.status(206);
+        response.header("Content-Type", type);
+        response.header("Content-Range", StringView(content_range, length));
+        response.header("Content-Length", static_cast<size_t>(ranges[0].last - ranges[0].first + 1));
+        response.header("ETag", file->etag);
+        response.header("Last-Modified", file->last_modified);
+
+        _end_head(response, headers, keep_alive);
+
+        response.body(file, ranges[0].first, ranges[0].last - ranges[0].first + 1);
+        return;
+    }
+
+    char boundary[RANGE_SIZE];
+    int  boundary_size = std::snprintf(boundary, sizeof(boundary), "%016llx",
+                                       static_cast<unsigned long long>(boundaries++));
+
+    // every part head is formatted first, the total length goes in the response head
+    size_t body_size = 0;
+
+    parts.clear();
+
+    for (size_t i = 0; i < count; i++) {
+        length = std::snprintf(content_range, sizeof(content_range), "bytes %llu-%llu/%llu",
+                               static_cast<unsigned long long>(ranges[i].first),
+                               static_cast<unsigned long long>(ranges[i].last),
+                               size);
+
+        part_ends[i] = parts.size();
+
+        parts.append(i == 0 ? "--" : "\r\n--");
+        parts.append(boundary, boundary_size);
+        parts.append("\r\nContent-Type: ");
+        parts.append(type.data(), type.size());
+        parts.append("\r\nContent-Range: ");
+        parts.append(content_range, length);
+        parts.append("\r\n\r\n");
+
+        body_size += ranges[i].last - ranges[i].first + 1;
+    }
+
+    part_ends[count] = parts.size();
+
+    parts.append("\r\n--");
+    parts.append(boundary, boundary_size);
+    parts.append("--\r\n");
+
+    body_size += parts.size();
+
+    response.status(206);
+    response.header("Content-Type", StringView("multipart/byteranges; boundary=" + std::string(boundary, boundary_size)));
+    response.header("Content-Length", body_size);
+    response.header("ETag", file->etag);
+    response.header("Last-Modified", file->last_modified);
+
+    _end_head(response, headers, keep_alive);
+
+    for (size_t i = 0; i < count; i++) {
+        response.body(StringView(parts.data() + part_ends[i], part_ends[i + 1] - part_ends[i]));
+        response.body(file, ranges[i].first, ranges[i].last - ranges[i].first + 1);
+    }
+
+    response.body(StringView(parts.data() + part_ends[count], parts.size() - part_ends[count]));
+}
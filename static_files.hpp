@@ -0,0 +1,79 @@
+#ifndef HTTPWEBSERVER_SOCKET_STATIC_FILES_HPP__
+#define HTTPWEBSERVER_SOCKET_STATIC_FILES_HPP__
+
+#include <string>
+#include <cstdint>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+#include "string_view.hpp"
+#include "http_parser.hpp"
+#include "header_cache.hpp"
+#include "response_builder.hpp"
+#include "file_cache.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief inclusive byte offsets, as in a Range header
+ */
+struct ByteRange
+{
+    uint64_t first;
+    uint64_t last;
+};
+
+/**
+ * @brief answers GET and HEAD requests with the files under a directory
+ *
+ * File bodies are queued as `sendfile` segments. `ETag` and
+ * `Last-Modified` come from the cached inode metadata, so a conditional
+ * request that matches is answered with a 304 without touching the disk.
+ * Range requests get a 206 whose parts are `sendfile` segments of their
+ * own, several ranges as `multipart/byteranges`.
+ */
+class __HttpWebServerSocketPort__ StaticFiles
+{
+private:
+    std::string root;
+    FileCache   cache;
+
+    /**
+     * @brief the file a request resolves to, reused to keep lookups free of allocations
+     */
+    std::string path;
+
+    static const size_t MAX_RANGES = 16;
+
+    /**
+     * @brief part heads of a multipart response and where each one ends
+     */
+    std::string parts;
+    size_t      part_ends[MAX_RANGES + 1];
+    uint64_t    boundaries;
+
+public:
+    explicit StaticFiles(const std::string&);
+
+    StaticFiles(const StaticFiles&) = delete;
+    StaticFiles& operator=(const StaticFiles&) = delete;
+
+    /**
+     * @brief queue the whole response to `request`
+     * @param now milliseconds on the loop clock
+     */
+    void serve(const HttpRequest&, ResponseBuilder&, const HeaderCache&, const bool, const uint64_t);
+
+private:
+    bool resolve(const StringView&);
+    void serve_ranges(const std::shared_ptr<const OpenFile>&,
+                      const ByteRange*,
+                      const size_t,
+                      ResponseBuilder&,
+                      const HeaderCache&,
+                      const bool);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_STATIC_FILES_HPP__ */
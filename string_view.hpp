@@ -0,0 +1,162 @@
+#ifndef HTTPWEBSERVER_SOCKET_STRING_VIEW_HPP__
+#define HTTPWEBSERVER_SOCKET_STRING_VIEW_HPP__
+
+#include <string>
+#include <ostream>
+#include <cstring>
+#include <cstddef>
+
+namespace nt { namespace http {
+
+/**
+ * @brief non-owning reference to characters in someone else's buffer
+ *
+ * Stand-in for std::string_view, which needs C++17. Only valid as long as
+ * the buffer it points into is neither freed nor moved.
+ */
+class StringView
+{
+private:
+    const char* _data;
+    size_t      _size;
+
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+public:
+    StringView() :
+          _data(""),
+          _size(0)
+    {
+    }
+
+    StringView(const char* data, const size_t size) :
+          _data(data),
+          _size(size)
+    {
+    }
+
+    StringView(const char* data) :
+          _data(data),
+          _size(std::strlen(data))
+    {
+    }
+
+    StringView(const std::string& s) :
+          _data(s.data()),
+          _size(s.size())
+    {
+    }
+
+    const char*
+    data() const
+    {
+        return _data;
+    }
+
+    size_t
+    size() const
+    {
+        return _size;
+    }
+
+    bool
+    empty() const
+    {
+        return _size == 0;
+    }
+
+    const char*
+    begin() const
+    {
+        return _data;
+    }
+
+    const char*
+    end() const
+    {
+        return _data + _size;
+    }
+
+    char
+    operator[](const size_t i) const
+    {
+        return _data[i];
+    }
+
+    StringView
+    substr(const size_t from, const size_t count = npos) const
+    {
+        size_t start = from < _size ? from : _size;
+        size_t left  = _size - start;
+
+        return StringView(_data + start, count < left ? count : left);
+    }
+
+    size_t
+    find(const char c, const size_t from = 0) const
+    {
+        if (from >= _size) {
+            return npos;
+        }
+
+        auto found = static_cast<const char*>(std::memchr(_data + from, c, _size - from));
+
+        return found == nullptr ? npos : static_cast<size_t>(found - _data);
+    }
+
+    bool
+    operator==(const StringView& other) const
+    {
+        return _size == other._size && std::memcmp(_data, other._data, _size) == 0;
+    }
+
+    bool
+    operator!=(const StringView& other) const
+    {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief ASCII only, which is all header names and tokens can hold
+     */
+    bool
+    equals_ignore_case(const StringView& other) const
+    {
+        if (_size != other._size) {
+            return false;
+        }
+
+        for (size_t i = 0; i < _size; i++) {
+            char a = _data[i];
+            char b = other._data[i];
+
+            if (a != b && (a | 0x20) != (b | 0x20)) {
+                return false;
+            }
+
+            // only letters may differ by the case bit
+            if (a != b && !((a | 0x20) >= 'a' && (a | 0x20) <= 'z')) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::string
+    to_string() const
+    {
+        return std::string(_data, _size);
+    }
+
+    friend std::ostream&
+    operator<<(std::ostream& out, const StringView& s)
+    {
+        return out.write(s._data, static_cast<std::streamsize>(s._size));
+    }
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_STRING_VIEW_HPP__ */
@@ -0,0 +1,188 @@
+#include "timer_wheel.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace nt::http;
+
+namespace {
+
+inline unsigned int
+_lowest_bit(const uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+
+    _BitScanForward64(&index, bits);
+
+    return index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+}
+
+Timer::Timer() :
+      next(nullptr),
+      prev(nullptr),
+      expires(0),
+      level(0),
+      slot(0),
+      kind(0),
+      data(nullptr)
+{
+}
+
+bool
+Timer::is_scheduled() const
+{
+    return next != nullptr;
+}
+
+TimerWheel::TimerWheel(const uint64_t now) :
+      current(now),
+      count(0)
+{
+    for (unsigned int level = 0; level < LEVELS; level++) {
+        occupied[level] = 0;
+
+        for (unsigned int slot = 0; slot < SLOTS; slot++) {
+            slots[level][slot].next = &slots[level][slot];
+            slots[level][slot].prev = &slots[level][slot];
+        }
+    }
+}
+
+void
+TimerWheel::schedule(Timer* timer, const uint64_t expires)
+{
+    if (timer->is_scheduled()) {
+        unlink(timer);
+    }
+
+    timer->expires = expires;
+
+    // never into the slot being expired, that one was already walked
+    link(timer, expires > current ? expires : current + 1);
+}
+
+void
+TimerWheel::cancel(Timer* timer)
+{
+    if (timer->is_scheduled()) {
+        unlink(timer);
+    }
+}
+
+size_t
+TimerWheel::size() const
+{
+    return count;
+}
+
+long
+TimerWheel::next_timeout() const
+{
+    if (count == 0) {
+        return -1;
+    }
+
+    unsigned int index = current & SLOT_MASK;
+
+    // the next slot above cascades once this level wraps
+    long wrap = SLOTS - index;
+
+    if (occupied[0] != 0) {
+        // rotate so the slot after the current one is bit 0
+        uint64_t after = (index + 1) & SLOT_MASK;
+        uint64_t bits  = (occupied[0] >> after) | (after == 0 ? 0 : occupied[0] << (SLOTS - after));
+
+        long first = _lowest_bit(bits) + 1;
+
+        // a timer above may come due before the first one on this level
+        for (unsigned int level = 1; level < LEVELS; level++) {
+            if (occupied[level] != 0) {
+                return first < wrap ? first : wrap;
+            }
+        }
+
+        return first;
+    }
+
+    // nothing on the first level, wake up when the next slot above cascades
+    return wrap;
+}
+
+void
+TimerWheel::link(Timer* timer, uint64_t due)
+{
+    uint64_t delta = due - current;
+
+    unsigned int level = 0;
+
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    if (delta >= (uint64_t(1) << (SLOT_BITS * LEVELS))) {
+        // out of range, park it in the furthest slot and let it cascade again
+        due = current + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    }
+
+    unsigned int slot = (due >> (SLOT_BITS * level)) & SLOT_MASK;
+    Timer*       head = &slots[level][slot];
+
+    timer->level = static_cast<unsigned char>(level);
+    timer->slot  = static_cast<unsigned char>(slot);
+    timer->prev  = head->prev;
+    timer->next  = head;
+
+    head->prev->next = timer;
+    head->prev       = timer;
+
+    occupied[level] |= uint64_t(1) << slot;
+    count++;
+}
+
+void
+TimerWheel::unlink(Timer* timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+
+    Timer* head = &slots[timer->level][timer->slot];
+
+    if (head->next == head) {
+        occupied[timer->level] &= ~(uint64_t(1) << timer->slot);
+    }
+
+    timer->next = nullptr;
+    timer->prev = nullptr;
+    count--;
+}
+
+void
+TimerWheel::cascade(const unsigned int level)
+{
+    if (level >= LEVELS) {
+        return;
+    }
+
+    unsigned int index = (current >> (SLOT_BITS * level)) & SLOT_MASK;
+
+    if (index == 0) {
+        cascade(level + 1);
+    }
+
+    Timer* head = &slots[level][index];
+
+    // everything here is due within one turn of the level below
+    while (head->next != head) {
+        Timer* timer = head->next;
+
+        unlink(timer);
+        link(timer, timer->expires > current ? timer->expires : current);
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef HTTPWEBSERVER_SOCKET_TIMER_WHEEL_HPP__
+#define HTTPWEBSERVER_SOCKET_TIMER_WHEEL_HPP__
+
+#include <cstdint>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief intrusive timer node, embed it in whatever owns the deadline
+ */
+struct Timer
+{
+    Timer*   next;
+    Timer*   prev;
+    uint64_t expires;
+
+    unsigned char level;
+    unsigned char slot;
+
+    /**
+     * @brief free for the owner, e.g. which deadline this is
+     */
+    unsigned int kind;
+    void*        data;
+
+    Timer();
+
+    bool is_scheduled() const;
+};
+
+/**
+ * @brief hierarchical timing wheel with millisecond ticks
+ *
+ * Four levels of 64 slots cover about 4.6 hours; later deadlines are
+ * clamped and re-cascaded. Scheduling and cancelling are O(1), expired
+ * timers are found by walking the ticks that passed since the last
+ * advance, cascading a higher level slot each time a lower level wraps.
+ */
+class __HttpWebServerSocketPort__ TimerWheel
+{
+private:
+    static const unsigned int LEVELS     = 4;
+    static const unsigned int SLOT_BITS  = 6;
+    static const unsigned int SLOTS      = 1 << SLOT_BITS;
+    static const uint64_t     SLOT_MASK  = SLOTS - 1;
+
+    Timer    slots[LEVELS][SLOTS];
+    uint64_t occupied[LEVELS];
+    uint64_t current;
+    size_t   count;
+
+public:
+    explicit TimerWheel(const uint64_t);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief (re)arm a timer to fire at the given absolute time
+     */
+    void schedule(Timer*, const uint64_t);
+    void cancel(Timer*);
+
+    /**
+     * @brief milliseconds until the wheel needs advancing, -1 when empty
+     */
+    long next_timeout() const;
+
+    size_t size() const;
+
+    /**
+     * @brief move the wheel to `now`, calling `expired(Timer*)` for each due timer
+     *
+     * A timer is unlinked before its callback runs, the callback may
+     * schedule or cancel any timer, including the one it was given.
+     */
+    template<typename F>
+    void
+    advance(const uint64_t now, F expired)
+    {
+        while (current < now) {
+            if (count == 0) {
+                current = now;
+                break;
+            }
+
+            current++;
+
+            unsigned int index = current & SLOT_MASK;
+
+            if (index == 0) {
+                cascade(1);
+            }
+
+            Timer* head = &slots[0][index];
+
+            while (head->next != head) {
+                Timer* timer = head->next;
+
+                unlink(timer);
+                expired(timer);
+            }
+        }
+    }
+
+private:
+    void link(Timer*, uint64_t);
+    void unlink(Timer*);
+    void cascade(const unsigned int);
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_TIMER_WHEEL_HPP__ */
@@ -6,60 +6,66 @@
 namespace nt { namespace http {
 
 Timeval::Timeval(const int seconds) :
-      time(std::make_unique<timeval>())
+      time({0}),
+      infinite(false)
 {
-    time->tv_sec  = seconds;
-    time->tv_usec = 0;
+    time.tv_sec  = seconds;
+    time.tv_usec = 0;
 }
 
 Timeval::Timeval(const double seconds) :
-      time(std::make_unique<timeval>())
+      time({0}),
+      infinite(false)
 {
     double integral;
 
-    time->tv_sec    = static_cast<int>(seconds);
+    time.tv_sec     = static_cast<int>(seconds);
     double fraction = std::modf(seconds, &integral);
-    time->tv_usec   = static_cast<int>(fraction * 1e6);
+    time.tv_usec    = static_cast<int>(fraction * 1e6);
 }
 
 Timeval::Timeval(const timeval t) :
-      time(std::make_unique<timeval>())
+      time(t),
+      infinite(false)
 {
-    time->tv_sec  = t.tv_sec;
-    time->tv_usec = t.tv_usec;
 }
 
-Timeval::Timeval(const Timeval& t) :
-    time(nullptr)
+Timeval::Timeval() :
+      time({0}),
+      infinite(true)
 {
-    if (t.time != nullptr) {
-        time = std::make_unique<timeval>();
-
-        time->tv_sec  = t.time->tv_sec;
-        time->tv_usec = t.time->tv_usec;
-    }
 }
 
-Timeval::Timeval() :
-    time(nullptr)
+Timeval
+Timeval::from_milliseconds(const long milliseconds)
 {
+    if (milliseconds < 0) {
+        return Infinite;
+    }
+
+    timeval t;
+
+    t.tv_sec  = milliseconds / 1000;
+    t.tv_usec = (milliseconds % 1000) * 1000;
+
+    return Timeval(t);
 }
 
 Timeval::operator timeval*() const
 {
-    return time.get();
+    return infinite ? nullptr : &time;
 }
 
 std::string
 Timeval::to_string() const
 {
-    if (time == nullptr) {
+    if (infinite) {
         return "NULL";
     } else {
-        //int decimal = time->tv_usec / 1e6;
-        int decimal = time->tv_usec;
+        //int decimal = time.tv_usec / 1e6;
+        int decimal = time.tv_usec;
 
-        return std::to_string(time->tv_sec) +
+        return std::to_string(time.tv_sec) +
               "." +
               std::to_string(decimal);
     }
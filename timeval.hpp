@@ -15,13 +15,21 @@ public:
     const static Timeval Zero;
 
 private:
-    std::unique_ptr<timeval> time;
+    // handed out as a mutable pointer, select() may write the remaining time back
+    mutable timeval time;
+    bool            infinite;
 
 public:
     explicit Timeval(const int);
     explicit Timeval(const double);
     explicit Timeval(const timeval);
-    Timeval(const Timeval&);
+    Timeval(const Timeval&) = default;
+    Timeval& operator=(const Timeval&) = default;
+
+    /**
+     * @brief negative values wait forever
+     */
+    static Timeval from_milliseconds(const long);
 
     operator timeval*() const;
 
@@ -1,14 +1,273 @@
 #include "udp_socket.hpp"
 
+#include <stdexcept>
+#include <cstring>
+
+#include <macros/leave_loop_if.hpp>
+
+#include "poller.hpp"
+#include "utility/socket.hpp"
+
 using namespace nt::http;
 
-UdpSocket::UdpSocket()
-// :
-// #ifdef LINUX
-//       LinuxTcpSocket()
-// #else
-//       WindowsTcpSocket()
-// #endif
+UdpSocket::UdpSocket(LinuxTcpSocket& owner, interfaces::DatagramHandler* receiver, const size_t batch, const size_t size) :
+      loop(owner),
+      handler(receiver),
+      socket(INVALID_SOCKET),
+      batch_size(batch),
+      datagram_size(size),
+      receive_buffer(new char[batch * size]),
+      receive_messages(batch),
+      receive_vectors(batch),
+      receive_addresses(batch),
+      datagrams(batch),
+      send_buffer(new char[batch * size]),
+      send_messages(batch),
+      send_vectors(batch),
+      send_addresses(batch),
+      send_first(0),
+      send_count(0),
+      received(0),
+      sent(0),
+      dropped(0),
+      receive_calls(0),
+      send_calls(0)
+{
+    std::memset(receive_messages.data(), 0, batch * sizeof(mmsghdr));
+    std::memset(send_messages.data(), 0, batch * sizeof(mmsghdr));
+
+    // every message keeps its buffer and address slot, only lengths change
+    for (size_t i = 0; i < batch; i++) {
+        receive_vectors[i].iov_base = receive_buffer.get() + i * size;
+        receive_vectors[i].iov_len  = size;
+
+        receive_messages[i].msg_hdr.msg_iov     = &receive_vectors[i];
+        receive_messages[i].msg_hdr.msg_iovlen  = 1;
+        receive_messages[i].msg_hdr.msg_name    = &receive_addresses[i];
+        receive_messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+
+        send_vectors[i].iov_base = send_buffer.get() + i * size;
+        send_vectors[i].iov_len  = 0;
+
+        send_messages[i].msg_hdr.msg_iov    = &send_vectors[i];
+        send_messages[i].msg_hdr.msg_iovlen = 1;
+        send_messages[i].msg_hdr.msg_name   = &send_addresses[i];
+    }
+
+    watch.socket        = INVALID_SOCKET;
+    watch.events        = Poller::READ;
+    watch.ready         = Poller::NONE;
+    watch.is_persistent = true;
+    watch.command       = {nullptr, handle_ready, this};
+}
+
+UdpSocket::~UdpSocket() noexcept
+{
+    close();
+}
+
+void
+UdpSocket::bind(const char* host, const char* service)
+{
+    close();
+
+    socket = utility::socket::create_and_bind_socket(host, service, SOCK_DGRAM);
+
+    if (socket == INVALID_SOCKET) {
+        std::string error = std::string("Failed to bind datagram socket to port/service '") + service + "'.";
+        throw std::runtime_error(error.c_str());
+    }
+
+    int flags = ::fcntl(socket, F_GETFL, 0);
+
+    if (flags == -1 || ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1) {
+        close();
+        throw std::runtime_error("Failed to change socket blocking mode.");
+    }
+
+    ::fcntl(socket, F_SETFD, FD_CLOEXEC);
+
+    watch.socket = socket;
+    watch.events = Poller::READ;
+
+    loop.watch(&watch);
+}
+
+void
+UdpSocket::bind(const char* host, const unsigned short port)
+{
+    bind(host, std::to_string(port).c_str());
+}
+
+void
+UdpSocket::close()
+{
+    if (socket == INVALID_SOCKET) {
+        return;
+    }
+
+    loop.unwatch(&watch);
+
+    ::close(socket);
+
+    socket     = INVALID_SOCKET;
+    send_first = 0;
+    send_count = 0;
+}
+
+bool
+UdpSocket::send(const sockaddr* address, const socklen_t address_size, const StringView& data)
+{
+    if (socket == INVALID_SOCKET || data.size() > datagram_size || address_size > sizeof(sockaddr_storage)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (send_count == batch_size) {
+        flush();
+    }
+
+    // the kernel has not taken the last batch yet
+    if (send_count == batch_size) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t i = send_count++;
+
+    std::memcpy(send_vectors[i].iov_base, data.data(), data.size());
+    std::memcpy(&send_addresses[i], address, address_size);
+
+    send_vectors[i].iov_len              = data.size();
+    send_messages[i].msg_hdr.msg_namelen = address_size;
+
+    return true;
+}
+
+bool
+UdpSocket::send(const Datagram& to, const StringView& data)
+{
+    return send(to.address, to.address_size, data);
+}
+
+void
+UdpSocket::flush()
+{
+    while (send_first < send_count) {
+        int count = ::sendmmsg(socket, &send_messages[send_first], send_count - send_first, MSG_DONTWAIT);
+
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // the rest goes once the socket is writable
+                set_events(Poller::READ | Poller::WRITE);
+                return;
+            }
+
+            continue_if (errno == EINTR);
+
+            // the kernel refused the first one, e.g. an unreachable address, the rest may still go
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            send_first++;
+            continue;
+        }
+
+        send_calls.fetch_add(1, std::memory_order_relaxed);
+        sent.fetch_add(count, std::memory_order_relaxed);
+
+        send_first += count;
+    }
+
+    send_first = 0;
+    send_count = 0;
+
+    set_events(Poller::READ);
+}
+
+int
+UdpSocket::get_port() const
+{
+    return utility::socket::get_bound_port(socket);
+}
+
+UdpSocketStats
+UdpSocket::stats() const
+{
+    return {
+          received.load(std::memory_order_relaxed),
+          sent.load(std::memory_order_relaxed),
+          dropped.load(std::memory_order_relaxed),
+          receive_calls.load(std::memory_order_relaxed),
+          send_calls.load(std::memory_order_relaxed)
+    };
+}
+
+void
+UdpSocket::handle_ready(void* data)
+{
+    auto udp = static_cast<UdpSocket*>(data);
+
+    if (udp->watch.ready & Poller::WRITE) {
+        udp->flush();
+    }
+
+    if (udp->watch.ready & (Poller::READ | Poller::ERROR)) {
+        udp->receive();
+    }
+}
+
+void
+UdpSocket::receive()
 {
+    for (unsigned int batch = 0; batch < MAX_BATCHES; batch++) {
+        int count = ::recvmmsg(socket, receive_messages.data(), batch_size, MSG_DONTWAIT, nullptr);
+
+        // EAGAIN once drained
+        break_if (count <= 0);
+
+        receive_calls.fetch_add(1, std::memory_order_relaxed);
+
+        size_t kept = 0;
+
+        for (int i = 0; i < count; i++) {
+            msghdr& message = receive_messages[i].msg_hdr;
+
+            if (message.msg_flags & MSG_TRUNC) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                datagrams[kept++] = {
+                      StringView(static_cast<const char*>(receive_vectors[i].iov_base), receive_messages[i].msg_len),
+                      reinterpret_cast<const sockaddr*>(&receive_addresses[i]),
+                      message.msg_namelen
+                };
+            }
+
+            // written by the call, the next one needs the slot size back
+            message.msg_namelen = sizeof(sockaddr_storage);
+        }
+
+        received.fetch_add(kept, std::memory_order_relaxed);
+
+        if (kept != 0 && handler != nullptr) {
+            handler->on_datagrams(*this, datagrams.data(), kept);
+        }
+
+        // replies to the batch leave in one call
+        flush();
+
+        // a short batch means the socket is drained, a handler may also have closed it
+        break_if (socket == INVALID_SOCKET || static_cast<size_t>(count) < batch_size);
+    }
 }
 
+void
+UdpSocket::set_events(const unsigned int events)
+{
+    if (watch.events == events || socket == INVALID_SOCKET) {
+        return;
+    }
+
+    watch.events = events;
+
+    loop.unwatch(&watch);
+    loop.watch(&watch);
+}
@@ -1,31 +1,146 @@
 #ifndef HTTPWEBSERVER_UDP_SOCKET_HPP__
 #define HTTPWEBSERVER_UDP_SOCKET_HPP__
 
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include <sys/socket.h>
+
 #include "common.hpp"
 #include "interfaces/socket.hpp"
-
-// #ifdef LINUX
-// #    include "linux_tcp_socket.hpp"
-// #else
-// #    include "windows_tcp_socket.hpp"
-// #endif
+#include "interfaces/datagram_handler.hpp"
+#include "string_view.hpp"
+#include "linux_tcp_socket.hpp"
 
 namespace nt { namespace http {
 
+struct Datagram
+{
+    StringView data;
+
+    const sockaddr* address;
+    socklen_t       address_size;
+};
+
+struct UdpSocketStats
+{
+    uint64_t received;
+    uint64_t sent;
+
+    /**
+     * @brief datagrams lost here: truncated on receive, no room to queue or refused by the kernel on send
+     */
+    uint64_t dropped;
+
+    /**
+     * @brief `recvmmsg` and `sendmmsg` calls, the batches the datagrams came and went in
+     */
+    uint64_t receive_calls;
+    uint64_t send_calls;
+};
 
+/**
+ * @brief datagram socket served by the event loop of a LinuxTcpSocket
+ *
+ * Datagrams are read a batch at a time with `recvmmsg` into buffers and
+ * message headers allocated up front, and handed to the handler as one
+ * array. Replies are copied into a send batch of the same shape and go
+ * out with `sendmmsg` when the handler returns, when the batch is full or
+ * on `flush()`; what the kernel will not take yet waits for the socket to
+ * be writable, new datagrams are dropped while the batch stays full.
+ * Datagrams longer than the buffer size are dropped, not cut short.
+ *
+ * Bound with `SO_REUSEPORT`, one socket per loop spreads the traffic of
+ * one port over several loops. Everything but `stats()` is for the loop
+ * thread, which has to outlive the socket.
+ */
 class __HttpWebServerSocketPort__ UdpSocket
-//       :
-// #ifdef LINUX
-//       public nt::http::LinuxTcpSocket
-// #else
-//       public nt::http::WindowsTcpSocket
-// #endif
 {
+private:
+    /**
+     * @brief batches read per wakeup, the loop's other sockets get a turn after that
+     */
+    static const unsigned int MAX_BATCHES = 16;
+
+    LinuxTcpSocket&             loop;
+    interfaces::DatagramHandler* handler;
+
+    SOCKET socket;
+    Watch  watch;
+
+    size_t batch_size;
+    size_t datagram_size;
+
+    std::unique_ptr<char[]>       receive_buffer;
+    std::vector<mmsghdr>          receive_messages;
+    std::vector<iovec>            receive_vectors;
+    std::vector<sockaddr_storage> receive_addresses;
+    std::vector<Datagram>         datagrams;
+
+    std::unique_ptr<char[]>       send_buffer;
+    std::vector<mmsghdr>          send_messages;
+    std::vector<iovec>            send_vectors;
+    std::vector<sockaddr_storage> send_addresses;
+
+    /**
+     * @brief queued datagrams are `[send_first, send_count)`, the front went out already
+     */
+    size_t send_first;
+    size_t send_count;
+
+    std::atomic<uint64_t> received;
+    std::atomic<uint64_t> sent;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> receive_calls;
+    std::atomic<uint64_t> send_calls;
+
 public:
-    UdpSocket();
+    /**
+     * @param batch_size datagrams per `recvmmsg` and `sendmmsg` call
+     * @param datagram_size largest datagram received or sent
+     */
+    UdpSocket(LinuxTcpSocket&, interfaces::DatagramHandler*, const size_t = 64, const size_t = 2048);
+    ~UdpSocket() noexcept;
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    /**
+     * @brief open the socket and start reading on the loop
+     * @throw std::runtime_error if the address cannot be bound
+     */
+    void bind(const char*, const char*);
+    void bind(const char*, const unsigned short);
+    void close();
+
+    /**
+     * @brief queue a datagram to an address, copying it
+     * @return false if it was dropped
+     */
+    bool send(const sockaddr*, const socklen_t, const StringView&);
+
+    /**
+     * @brief queue a reply to where a received datagram came from
+     */
+    bool send(const Datagram&, const StringView&);
+
+    /**
+     * @brief hand the queued datagrams to the kernel
+     */
+    void flush();
+
+    int get_port() const;
+    UdpSocketStats stats() const;
+
+private:
+    static void handle_ready(void*);
+
+    void receive();
+    void set_events(const unsigned int);
 };
 
 }}
 
 #endif /* HTTPWEBSERVER_UDP_SOCKET_HPP__ */
-
@@ -0,0 +1,315 @@
+#include "uring.hpp"
+
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+using namespace nt::http;
+
+static inline int
+_io_uring_setup(unsigned int entries, io_uring_params* params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+static inline int
+_io_uring_enter(int handle, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, handle, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static inline int
+_io_uring_register(int handle, unsigned int opcode, void* arg, unsigned int count)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, handle, opcode, arg, count));
+}
+
+static inline void*
+_map(int handle, size_t size, off_t offset)
+{
+    void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, handle, offset);
+
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("Failed to map io_uring ring.");
+    }
+
+    return address;
+}
+
+static inline unsigned int*
+_at(void* ring, unsigned int offset)
+{
+    return reinterpret_cast<unsigned int*>(static_cast<char*>(ring) + offset);
+}
+
+Uring::Uring(const unsigned int entries) :
+      handle(-1),
+      sq_ring(nullptr),
+      cq_ring(nullptr),
+      sq_ring_size(0),
+      cq_ring_size(0),
+      sqe_tail(0),
+      sqe_head(0),
+      sqes(nullptr),
+      sqes_size(0),
+      buffer_ring(nullptr),
+      buffer_ring_size(0),
+      buffer_mask(0),
+      buffer_size(0),
+      buffer_group(0)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    // multishot requests can complete many times per submission
+    params.flags      = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 4;
+
+    if ((handle = _io_uring_setup(entries, &params)) == -1) {
+        throw std::runtime_error("Failed to set up io_uring.");
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+
+    sq_ring = _map(handle, sq_ring_size, IORING_OFF_SQ_RING);
+    cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP) ?
+              sq_ring :
+              _map(handle, cq_ring_size, IORING_OFF_CQ_RING);
+
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes      = static_cast<io_uring_sqe*>(_map(handle, sqes_size, IORING_OFF_SQES));
+
+    sq_head    = _at(sq_ring, params.sq_off.head);
+    sq_tail    = _at(sq_ring, params.sq_off.tail);
+    sq_mask    = *_at(sq_ring, params.sq_off.ring_mask);
+    sq_entries = *_at(sq_ring, params.sq_off.ring_entries);
+    sqe_tail   = *sq_tail;
+    sqe_head   = sqe_tail;
+
+    // submission slots map one to one onto the entries array
+    unsigned int* array = _at(sq_ring, params.sq_off.array);
+    for (unsigned int i = 0; i < sq_entries; i++) {
+        array[i] = i;
+    }
+
+    cq_head = _at(cq_ring, params.cq_off.head);
+    cq_tail = _at(cq_ring, params.cq_off.tail);
+    cq_mask = *_at(cq_ring, params.cq_off.ring_mask);
+    cqes    = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cq_ring) + params.cq_off.cqes);
+}
+
+Uring::~Uring() noexcept
+{
+    if (buffer_ring != nullptr) {
+        ::munmap(buffer_ring, buffer_ring_size);
+    }
+
+    if (sqes != nullptr) {
+        ::munmap(sqes, sqes_size);
+    }
+
+    if (cq_ring != nullptr && cq_ring != sq_ring) {
+        ::munmap(cq_ring, cq_ring_size);
+    }
+
+    if (sq_ring != nullptr) {
+        ::munmap(sq_ring, sq_ring_size);
+    }
+
+    if (handle != -1) {
+        ::close(handle);
+    }
+}
+
+io_uring_sqe*
+Uring::get_sqe()
+{
+    unsigned int head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+
+    if (sqe_tail - head >= sq_entries) {
+        // ring is full, flush what we have without waiting
+        submit(0);
+
+        head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+
+        if (sqe_tail - head >= sq_entries) {
+            throw std::runtime_error("io_uring submission queue is full.");
+        }
+    }
+
+    io_uring_sqe* sqe = &sqes[sqe_tail & sq_mask];
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    sqe_tail++;
+
+    return sqe;
+}
+
+int
+Uring::submit(const unsigned int wait_count)
+{
+    unsigned int pending = sqe_tail - sqe_head;
+
+    __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+
+    unsigned int flags = wait_count > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    if (pending == 0 && wait_count == 0) {
+        return 0;
+    }
+
+    int submitted = _io_uring_enter(handle, pending, wait_count, flags);
+
+    if (submitted == -1) {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+            return 0;
+        }
+
+        throw std::runtime_error("Failed to submit io_uring requests.");
+    }
+
+    sqe_head += submitted;
+
+    return submitted;
+}
+
+void
+Uring::register_buffers(const unsigned short group, const unsigned int count, const unsigned int size)
+{
+    if (count == 0 || (count & (count - 1)) != 0) {
+        throw std::runtime_error("Buffer count must be a power of two.");
+    }
+
+    buffer_ring_size = count * sizeof(io_uring_buf);
+    void* ring       = ::mmap(nullptr, buffer_ring_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+
+    if (ring == MAP_FAILED) {
+        throw std::runtime_error("Failed to allocate io_uring buffer ring.");
+    }
+
+    buffer_ring  = static_cast<io_uring_buf_ring*>(ring);
+    buffer_mask  = count - 1;
+    buffer_size  = size;
+    buffer_group = group;
+    buffers.resize(static_cast<size_t>(count) * size);
+
+    io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+
+    reg.ring_addr    = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = count;
+    reg.bgid         = group;
+
+    if (_io_uring_register(handle, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        throw std::runtime_error("Failed to register io_uring buffer ring.");
+    }
+
+    buffer_ring->tail = 0;
+
+    for (unsigned int i = 0; i < count; i++) {
+        recycle_buffer(static_cast<unsigned short>(i));
+    }
+}
+
+char*
+Uring::get_buffer(const unsigned short id)
+{
+    return &buffers[static_cast<size_t>(id) * buffer_size];
+}
+
+void
+Uring::recycle_buffer(const unsigned short id)
+{
+    unsigned short tail = buffer_ring->tail;
+
+    // in C++ the empty marker in front of the header's flexible array takes a byte and moves
+    // `bufs` off the ring, the entries start at the ring itself
+    io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(buffer_ring) + (tail & buffer_mask);
+
+    buf->addr = reinterpret_cast<uint64_t>(get_buffer(id));
+    buf->len  = buffer_size;
+    buf->bid  = id;
+
+    __atomic_store_n(&buffer_ring->tail, static_cast<unsigned short>(tail + 1), __ATOMIC_RELEASE);
+}
+
+void
+Uring::prepare_multishot_accept(SOCKET socket, const uint64_t user_data)
+{
+    io_uring_sqe* sqe = get_sqe();
+
+    sqe->opcode       = IORING_OP_ACCEPT;
+    sqe->fd           = socket;
+    sqe->ioprio       = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data    = user_data;
+}
+
+void
+Uring::prepare_multishot_recv(SOCKET socket, const uint64_t user_data)
+{
+    io_uring_sqe* sqe = get_sqe();
+
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = socket;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = buffer_group;
+    sqe->user_data = user_data;
+}
+
+void
+Uring::prepare_send(SOCKET socket, const char* data, const size_t size, const uint64_t user_data)
+{
+    io_uring_sqe* sqe = get_sqe();
+
+    sqe->opcode    = IORING_OP_SEND;
+    sqe->fd        = socket;
+    sqe->addr      = reinterpret_cast<uint64_t>(data);
+    sqe->len       = static_cast<unsigned int>(size);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = user_data;
+}
+
+void
+Uring::prepare_sendmsg(SOCKET socket, const msghdr* message, const uint64_t user_data)
+{
+    io_uring_sqe* sqe = get_sqe();
+
+    sqe->opcode    = IORING_OP_SENDMSG;
+    sqe->fd        = socket;
+    sqe->addr      = reinterpret_cast<uint64_t>(message);
+    sqe->len       = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = user_data;
+}
+
+void
+Uring::prepare_poll(int handle, const unsigned int events, const uint64_t user_data)
+{
+    io_uring_sqe* sqe = get_sqe();
+
+    sqe->opcode        = IORING_OP_POLL_ADD;
+    sqe->fd            = handle;
+    sqe->poll32_events = events;
+    sqe->user_data     = user_data;
+}
+
+void
+Uring::prepare_cancel(const uint64_t target, const uint64_t user_data)
+{
+    io_uring_sqe* sqe = get_sqe();
+
+    sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+    sqe->fd        = -1;
+    sqe->addr      = target;
+    sqe->user_data = user_data;
+}
@@ -0,0 +1,108 @@
+#ifndef HTTPWEBSERVER_SOCKET_URING_HPP__
+#define HTTPWEBSERVER_SOCKET_URING_HPP__
+
+#include <vector>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+
+#include "common.hpp"
+#include "interfaces/socket.hpp"
+
+namespace nt { namespace http {
+
+/**
+ * @brief minimal io_uring instance talking straight to the kernel interface
+ *
+ * Submission entries are only handed to the kernel by `submit()`, so
+ * everything prepared while draining completions goes out in one batch.
+ */
+class __HttpWebServerSocketPort__ Uring
+{
+private:
+    int handle;
+
+    void*  sq_ring;
+    void*  cq_ring;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+
+    unsigned int* sq_head;
+    unsigned int* sq_tail;
+    unsigned int  sq_mask;
+    unsigned int  sq_entries;
+    unsigned int  sqe_tail;
+    unsigned int  sqe_head;
+
+    io_uring_sqe* sqes;
+    size_t        sqes_size;
+
+    unsigned int* cq_head;
+    unsigned int* cq_tail;
+    unsigned int  cq_mask;
+    io_uring_cqe* cqes;
+
+    io_uring_buf_ring* buffer_ring;
+    size_t             buffer_ring_size;
+    unsigned int       buffer_mask;
+    unsigned int       buffer_size;
+    unsigned short     buffer_group;
+    std::vector<char>  buffers;
+
+public:
+    explicit Uring(const unsigned int);
+    ~Uring() noexcept;
+
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+
+    io_uring_sqe* get_sqe();
+    int submit(const unsigned int);
+
+    /**
+     * @brief hand a group of equally sized receive buffers to the kernel
+     */
+    void register_buffers(const unsigned short, const unsigned int, const unsigned int);
+    char* get_buffer(const unsigned short);
+    void recycle_buffer(const unsigned short);
+
+    void prepare_multishot_accept(SOCKET, const uint64_t);
+    void prepare_multishot_recv(SOCKET, const uint64_t);
+    void prepare_send(SOCKET, const char*, const size_t, const uint64_t);
+
+    /**
+     * @brief gathered send, the message and what it points at stay put until it completes
+     */
+    void prepare_sendmsg(SOCKET, const msghdr*, const uint64_t);
+
+    /**
+     * @brief complete once the descriptor is ready for any of `events`, e.g. POLLIN
+     */
+    void prepare_poll(int, const unsigned int, const uint64_t);
+
+    /**
+     * @brief cancel the request with this user data, it completes with -ECANCELED
+     */
+    void prepare_cancel(const uint64_t, const uint64_t);
+
+    template<typename F>
+    unsigned int
+    for_each_completion(F callback)
+    {
+        unsigned int head  = *cq_head;
+        unsigned int tail  = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        unsigned int count = 0;
+
+        for (; head != tail; head++, count++) {
+            callback(cqes[head & cq_mask]);
+        }
+
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+        return count;
+    }
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_URING_HPP__ */
@@ -0,0 +1,346 @@
+#include "scan.hpp"
+
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#    define HTTPWEBSERVER_SCAN_X86 1
+#    include <immintrin.h>
+#endif
+
+namespace nt { namespace http { namespace utility { namespace scan {
+
+namespace {
+
+const unsigned char TOKEN  = 1;
+const unsigned char TARGET = 2;
+const unsigned char VALUE  = 4;
+
+/**
+ * @brief character classes for the scalar path, plus the nibble tables the
+ *        AVX2 token kernel looks bytes up in
+ */
+struct CharClasses
+{
+    unsigned char classes[256];
+
+    // bit h of token_rows[l] is set when (h << 4 | l) is a token character
+    unsigned char token_rows[16];
+
+    CharClasses()
+    {
+        static const char separators[] = "\"(),/:;<=>?@[\\]{}";
+
+        for (int c = 0; c < 256; c++) {
+            unsigned char bits = 0;
+
+            if (c > 0x20 && c < 0x7f && std::strchr(separators, c) == nullptr) {
+                bits |= TOKEN;
+            }
+
+            if (c > 0x20 && c != 0x7f) {
+                bits |= TARGET;
+            }
+
+            if (c == '\t' || (c >= 0x20 && c != 0x7f)) {
+                bits |= VALUE;
+            }
+
+            classes[c] = bits;
+        }
+
+        std::memset(token_rows, 0, sizeof(token_rows));
+
+        for (int c = 0; c < 0x80; c++) {
+            if (classes[c] & TOKEN) {
+                token_rows[c & 0x0f] |= static_cast<unsigned char>(1 << (c >> 4));
+            }
+        }
+    }
+};
+
+const CharClasses _chars;
+
+inline size_t
+_find_scalar(const char* data, const size_t from, const size_t size, const unsigned char accepted)
+{
+    size_t i = from;
+
+    while (i < size && (_chars.classes[static_cast<unsigned char>(data[i])] & accepted)) {
+        i++;
+    }
+
+    return i;
+}
+
+size_t
+_scalar_non_token(const char* data, const size_t size)
+{
+    return _find_scalar(data, 0, size, TOKEN);
+}
+
+size_t
+_scalar_non_target(const char* data, const size_t size)
+{
+    return _find_scalar(data, 0, size, TARGET);
+}
+
+size_t
+_scalar_non_value(const char* data, const size_t size)
+{
+    return _find_scalar(data, 0, size, VALUE);
+}
+
+#ifdef HTTPWEBSERVER_SCAN_X86
+
+// byte ranges (pairs of first and last) that stop a scan, for PCMPESTRI
+alignas(16) const char NON_TOKEN_RANGES[16]  = {'\x00', ' ', '"', '"', '(', ')', ',', ',',
+                                                '/', '/', ':', '@', '[', ']', '{', '\xff'};
+alignas(16) const char NON_TARGET_RANGES[16] = {'\x00', ' ', '\x7f', '\x7f'};
+alignas(16) const char NON_VALUE_RANGES[16]  = {'\x00', '\x08', '\x0a', '\x1f', '\x7f', '\x7f'};
+
+/**
+ * @brief 16 bytes at a time, the ranges may over-match, `accepted` has the final word
+ */
+__attribute__((target("sse4.2")))
+inline size_t
+_sse42_find(const char* data, const size_t size, const char* ranges, const int ranges_size, const unsigned char accepted)
+{
+    const __m128i stops = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+
+    size_t i = 0;
+
+    while (i + 16 <= size) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int     index = _mm_cmpestri(stops, ranges_size, block, 16,
+                                     _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+
+        if (index == 16) {
+            i += 16;
+            continue;
+        }
+
+        i += index;
+
+        if (!(_chars.classes[static_cast<unsigned char>(data[i])] & accepted)) {
+            return i;
+        }
+
+        i++;
+    }
+
+    return _find_scalar(data, i, size, accepted);
+}
+
+__attribute__((target("sse4.2")))
+size_t
+_sse42_non_token(const char* data, const size_t size)
+{
+    // '|' and '~' fall into the last range, they are checked one by one
+    return _sse42_find(data, size, NON_TOKEN_RANGES, 16, TOKEN);
+}
+
+__attribute__((target("sse4.2")))
+size_t
+_sse42_non_target(const char* data, const size_t size)
+{
+    return _sse42_find(data, size, NON_TARGET_RANGES, 4, TARGET);
+}
+
+__attribute__((target("sse4.2")))
+size_t
+_sse42_non_value(const char* data, const size_t size)
+{
+    return _sse42_find(data, size, NON_VALUE_RANGES, 6, VALUE);
+}
+
+__attribute__((target("avx2")))
+inline __m256i
+_avx2_at_most(const __m256i block, const char c)
+{
+    // unsigned block <= c
+    return _mm256_cmpeq_epi8(_mm256_max_epu8(block, _mm256_set1_epi8(c)), _mm256_set1_epi8(c));
+}
+
+struct Avx2NonToken
+{
+    __attribute__((target("avx2")))
+    __m256i
+    operator()(const __m256i block) const
+    {
+        const __m256i rows = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_chars.token_rows)));
+        const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                              1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m256i low  = _mm256_set1_epi8(0x0f);
+
+        // a byte is a token when its high nibble's bit is set in its low nibble's row
+        __m256i row = _mm256_shuffle_epi8(rows, _mm256_and_si256(block, low));
+        __m256i bit = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(block, 4), low));
+
+        return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), _mm256_setzero_si256());
+    }
+};
+
+struct Avx2NonTarget
+{
+    __attribute__((target("avx2")))
+    __m256i
+    operator()(const __m256i block) const
+    {
+        return _mm256_or_si256(_avx2_at_most(block, ' '),
+                               _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\x7f')));
+    }
+};
+
+struct Avx2NonValue
+{
+    __attribute__((target("avx2")))
+    __m256i
+    operator()(const __m256i block) const
+    {
+        __m256i control = _mm256_andnot_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')),
+                                              _avx2_at_most(block, '\x1f'));
+
+        return _mm256_or_si256(control, _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\x7f')));
+    }
+};
+
+/**
+ * @brief 32 bytes at a time, `Stops` maps a block to a mask of the bytes that end the scan
+ */
+template<typename Stops>
+__attribute__((target("avx2")))
+inline size_t
+_avx2_find(const char* data, const size_t size, const unsigned char accepted)
+{
+    const Stops stops;
+
+    size_t i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i  block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned mask  = static_cast<unsigned>(_mm256_movemask_epi8(stops(block)));
+
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return _find_scalar(data, i, size, accepted);
+}
+
+__attribute__((target("avx2")))
+size_t
+_avx2_non_token(const char* data, const size_t size)
+{
+    return _avx2_find<Avx2NonToken>(data, size, TOKEN);
+}
+
+__attribute__((target("avx2")))
+size_t
+_avx2_non_target(const char* data, const size_t size)
+{
+    return _avx2_find<Avx2NonTarget>(data, size, TARGET);
+}
+
+__attribute__((target("avx2")))
+size_t
+_avx2_non_value(const char* data, const size_t size)
+{
+    return _avx2_find<Avx2NonValue>(data, size, VALUE);
+}
+
+#endif
+
+struct Kernels
+{
+    Isa isa;
+
+    size_t (* non_token)(const char*, const size_t);
+    size_t (* non_target)(const char*, const size_t);
+    size_t (* non_value)(const char*, const size_t);
+};
+
+Isa
+_detect_isa()
+{
+#ifdef HTTPWEBSERVER_SCAN_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    } else if (__builtin_cpu_supports("sse4.2")) {
+        return Isa::Sse42;
+    }
+#endif
+
+    return Isa::Scalar;
+}
+
+Kernels
+_get_kernels(const Isa isa)
+{
+    switch (isa) {
+#ifdef HTTPWEBSERVER_SCAN_X86
+    case Isa::Avx2:
+        return {isa, _avx2_non_token, _avx2_non_target, _avx2_non_value};
+    case Isa::Sse42:
+        return {isa, _sse42_non_token, _sse42_non_target, _sse42_non_value};
+#endif
+    default:
+        return {Isa::Scalar, _scalar_non_token, _scalar_non_target, _scalar_non_value};
+    }
+}
+
+const Isa _supported = _detect_isa();
+
+Kernels _kernels = _get_kernels(_supported);
+
+}
+
+Isa
+get_supported_isa()
+{
+    return _supported;
+}
+
+Isa
+get_isa()
+{
+    return _kernels.isa;
+}
+
+void
+set_isa(const Isa isa)
+{
+    _kernels = _get_kernels(static_cast<int>(isa) > static_cast<int>(_supported) ? _supported : isa);
+}
+
+const char*
+to_string(const Isa isa)
+{
+    switch (isa) {
+    case Isa::Avx2:  return "avx2";
+    case Isa::Sse42: return "sse4.2";
+    default:         return "scalar";
+    }
+}
+
+size_t
+find_non_token(const char* data, const size_t size)
+{
+    return _kernels.non_token(data, size);
+}
+
+size_t
+find_non_target(const char* data, const size_t size)
+{
+    return _kernels.non_target(data, size);
+}
+
+size_t
+find_non_value(const char* data, const size_t size)
+{
+    return _kernels.non_value(data, size);
+}
+
+}}}}
@@ -0,0 +1,59 @@
+#ifndef HTTPWEBSERVER_SOCKET_HPP_UTILITY_SCAN__
+#define HTTPWEBSERVER_SOCKET_HPP_UTILITY_SCAN__
+
+#include <cstddef>
+
+#include "../common.hpp"
+
+namespace nt { namespace http { namespace utility { namespace scan {
+
+/**
+ * @brief instruction sets the scanners come in
+ */
+enum class Isa
+{
+    Scalar,
+    Sse42,
+    Avx2
+};
+
+/**
+ * @brief the best the running CPU supports, looked up once through CPUID
+ */
+Isa get_supported_isa();
+
+/**
+ * @brief the kernels in use, the supported ones unless `set_isa()` said otherwise
+ */
+Isa get_isa();
+
+/**
+ * @brief switch kernels, e.g. to compare them; clamped to what the CPU supports
+ *
+ * Not thread safe, call it before any event loop runs.
+ */
+void set_isa(const Isa);
+
+const char* to_string(const Isa);
+
+/**
+ * @return offset of the first byte that may not appear in a method or
+ *         header name (':', white space, CR, ...), `size` if there is none
+ */
+size_t find_non_token(const char*, const size_t);
+
+/**
+ * @return offset of the first byte that ends a request target (white space
+ *         or a control character), `size` if there is none
+ */
+size_t find_non_target(const char*, const size_t);
+
+/**
+ * @return offset of the first byte that may not appear in a header value
+ *         (CR, LF or another control character but tab), `size` if there is none
+ */
+size_t find_non_value(const char*, const size_t);
+
+}}}}
+
+#endif /* HTTPWEBSERVER_SOCKET_HPP_UTILITY_SCAN__ */
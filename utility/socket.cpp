@@ -115,14 +115,14 @@ get_bound_port(SOCKET socket)
 }
 
 static addrinfo*
-_get_addrinfo(const char* server_address, const char* port)
+_get_addrinfo(const char* server_address, const char* port, const int type)
 {
     addrinfo* server_info;
     addrinfo hints = {0};
 
     hints.ai_family   = AF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-    hints.ai_protocol =  IPPROTO_IP, // ANY TCP
+    hints.ai_socktype = type;
+    hints.ai_protocol = IPPROTO_IP; // whichever goes with the type
     hints.ai_flags    = AI_PASSIVE;
 
     int result = 0;
@@ -172,7 +172,7 @@ _close_socket(int socket)
 }
 
 SOCKET
-create_and_bind_socket(const char* host, const char* service)
+create_and_bind_socket(const char* host, const char* service, const int type)
 {
     addrinfo* server_info = nullptr;
 
@@ -182,7 +182,7 @@ create_and_bind_socket(const char* host, const char* service)
               }
     _____________________________________________________________;
 
-    server_info = _get_addrinfo(host, service);
+    server_info = _get_addrinfo(host, service, type);
 
     if (server_info == nullptr) {
         return INVALID_SOCKET;
@@ -238,9 +238,9 @@ create_and_bind_socket(const char* host, const char* service)
 }
 
 SOCKET
-create_and_bind_socket(const char* host, const int port)
+create_and_bind_socket(const char* host, const int port, const int type)
 {
-    return create_and_bind_socket(host, std::to_string(port).c_str());
+    return create_and_bind_socket(host, std::to_string(port).c_str(), type);
 }
 
 }}}}
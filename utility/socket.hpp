@@ -39,8 +39,11 @@ get_in_port(sockaddr_storage* sa)
 
 int get_bound_port(SOCKET socket);
 
-SOCKET create_and_bind_socket(const char*, const char*);
-SOCKET create_and_bind_socket(const char*, const int);
+/**
+ * @param type `SOCK_STREAM` or `SOCK_DGRAM`
+ */
+SOCKET create_and_bind_socket(const char*, const char*, const int = SOCK_STREAM);
+SOCKET create_and_bind_socket(const char*, const int, const int = SOCK_STREAM);
 
 }}}}
 
@@ -494,7 +494,7 @@ WindowsTcpSocket::open()
         if (_is_set({FD_ACCEPT}, networkEvents.lNetworkEvents)) {
             std::cout << "accept\n";
 
-            auto client = cx->socket->accept();
+            auto client = std::make_shared<RawSocket>(cx->socket->accept());
 
             // receive_data(client);
             // write_data(client);
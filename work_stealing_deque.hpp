@@ -0,0 +1,195 @@
+#ifndef HTTPWEBSERVER_SOCKET_WORK_STEALING_DEQUE_HPP__
+#define HTTPWEBSERVER_SOCKET_WORK_STEALING_DEQUE_HPP__
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace nt { namespace http {
+
+/**
+ * @brief Chase-Lev deque of pointers, one owner and any number of thieves
+ *
+ * The owner pushes and pops at the bottom without contention, thieves
+ * take from the top with one compare-and-swap; the two only race for
+ * the last element. The ring grows when full and old rings are kept
+ * until the deque goes away, a thief may still be reading one. Memory
+ * orders follow Lê et al., "Correct and Efficient Work-Stealing for
+ * Weak Memory Models".
+ */
+template<typename T>
+class WorkStealingDeque
+{
+private:
+    static const size_t CACHE_LINE = 64;
+
+    struct Ring
+    {
+        const size_t                       mask;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+
+        explicit Ring(const size_t capacity) :
+              mask(capacity - 1),
+              slots(new std::atomic<T*>[capacity])
+        {
+        }
+
+        size_t
+        capacity() const
+        {
+            return mask + 1;
+        }
+
+        T*
+        get(const int64_t index) const
+        {
+            return slots[index & mask].load(std::memory_order_relaxed);
+        }
+
+        void
+        put(const int64_t index, T* item)
+        {
+            slots[index & mask].store(item, std::memory_order_relaxed);
+        }
+    };
+
+    // padding instead of alignas, over-aligned new is C++17
+    char                 pad0[CACHE_LINE];
+    std::atomic<int64_t> top;
+    char                 pad1[CACHE_LINE];
+    std::atomic<int64_t> bottom;
+    std::atomic<Ring*>   ring;
+    char                 pad2[CACHE_LINE];
+
+    /**
+     * @brief every ring ever used, owned here so thieves never read freed memory
+     */
+    std::vector<std::unique_ptr<Ring>> rings;
+
+public:
+    /**
+     * @param capacity initial size, a power of two
+     */
+    explicit WorkStealingDeque(const size_t capacity = 256) :
+          top(0),
+          bottom(0)
+    {
+        rings.push_back(std::unique_ptr<Ring>(new Ring(capacity)));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * @brief owner side
+     */
+    void
+    push(T* item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring*   r = ring.load(std::memory_order_relaxed);
+
+        if (b - t > static_cast<int64_t>(r->capacity()) - 1) {
+            r = grow(r, t, b);
+        }
+
+        r->put(b, item);
+
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief owner side, the most recently pushed item
+     * @return nullptr when empty
+     */
+    T*
+    pop()
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring*   r = ring.load(std::memory_order_relaxed);
+
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = r->get(b);
+
+        // the last item, a thief may be after it too
+        if (t == b) {
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    /**
+     * @brief thief side, safe from any thread, the oldest item
+     * @return nullptr when empty or another thread got there first
+     */
+    T*
+    steal()
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+
+        T* item = ring.load(std::memory_order_acquire)->get(t);
+
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+
+        return item;
+    }
+
+    /**
+     * @brief a guess, exact only on the owner thread while no thief is active
+     */
+    bool
+    empty() const
+    {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    Ring*
+    grow(Ring* old, const int64_t t, const int64_t b)
+    {
+        rings.push_back(std::unique_ptr<Ring>(new Ring(old->capacity() * 2)));
+
+        Ring* larger = rings.back().get();
+
+        for (int64_t i = t; i < b; i++) {
+            larger->put(i, old->get(i));
+        }
+
+        ring.store(larger, std::memory_order_release);
+
+        return larger;
+    }
+};
+
+}}
+
+#endif /* HTTPWEBSERVER_SOCKET_WORK_STEALING_DEQUE_HPP__ */